@@ -0,0 +1,522 @@
+#include "book_file.h"
+#include "utils.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        CloseHandle(handle);
+        return false;
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length == 0) {
+        // Un archivo vacio no se puede proyectar: se abre sin bytes
+        CloseHandle(handle);
+        return true;
+    }
+    
+    // La vista mantiene vivos el archivo y la proyeccion, los handles se cierran ya
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(handle);
+    if (!mapping) {
+        length = 0;
+        return false;
+    }
+    bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+#else
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+    
+    struct stat info;
+    if (fstat(descriptor, &info) != 0) {
+        ::close(descriptor);
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        ::close(descriptor);
+        return true;
+    }
+    
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    bytes = mapped == MAP_FAILED ? nullptr : static_cast<const char*>(mapped);
+#endif
+
+    if (!bytes) {
+        length = 0;
+        return false;
+    }
+    return true;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        bytes = other.bytes;
+        length = other.length;
+        other.bytes = nullptr;
+        other.length = 0;
+    }
+    return *this;
+}
+
+void MappedFile::close() {
+    if (bytes) {
+#ifdef _WIN32
+        UnmapViewOfFile(bytes);
+#else
+        munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+    bytes = nullptr;
+    length = 0;
+}
+
+bool MappedBook::open(const std::string& path, bool (*acceptKey)(std::string_view)) {
+    close();
+    if (!file.open(path)) {
+        std::cerr << "Error: No se pudo abrir el archivo " << path << std::endl;
+        return false;
+    }
+    
+    std::string_view bytes = file.view();
+    binary = bytes.length() >= sizeof(Magic) && std::memcmp(bytes.data(), Magic, sizeof(Magic)) == 0;
+    if (!binary) {
+        indexText(acceptKey);
+    } else if (!validate()) {
+        std::cerr << "Error: El archivo " << path << " no es un libro binario valido" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedBook::close() {
+    file.close();
+    binary = false;
+    entries.clear();
+    index = nullptr;
+    keys = nullptr;
+    values = nullptr;
+    count = 0;
+}
+
+// Comprueba la cabecera y que cada clave y valor quede dentro del archivo
+bool MappedBook::validate() {
+    std::string_view bytes = file.view();
+    if (bytes.length() < sizeof(Header)) return false;
+    
+    Header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version) return false;
+    
+    uint64_t indexEnd = sizeof(Header) + static_cast<uint64_t>(header.count) * sizeof(IndexEntry);
+    if (indexEnd > header.keysOffset || header.keysOffset > header.valuesOffset || header.valuesOffset > bytes.length()) {
+        return false;
+    }
+    
+    index = reinterpret_cast<const IndexEntry*>(bytes.data() + sizeof(Header));
+    keys = bytes.data() + header.keysOffset;
+    values = bytes.data() + header.valuesOffset;
+    count = header.count;
+    
+    uint64_t keysSize = header.valuesOffset - header.keysOffset;
+    uint64_t valuesSize = bytes.length() - header.valuesOffset;
+    for (size_t i = 0; i < count; i++) {
+        const IndexEntry& entry = index[i];
+        if (entry.keyOffset + entry.keyLength > keysSize || entry.valueOffset + entry.valueLength > valuesSize ||
+            entry.type > static_cast<uint8_t>(BookType::Lista)) {
+            return false;
+        }
+        bool numeric = entry.type == static_cast<uint8_t>(BookType::Entero) || entry.type == static_cast<uint8_t>(BookType::Decimal);
+        if (numeric && entry.valueLength != 8) return false;
+        if (i > 0 && keyAt(i - 1) >= keyAt(i)) return false;
+    }
+    return true;
+}
+
+BookType MappedBook::typeFromName(std::string_view name) {
+    if (name == "entero") return BookType::Entero;
+    if (name == "decimal") return BookType::Decimal;
+    if (name == "lista") return BookType::Lista;
+    return BookType::Texto;
+}
+
+const char* MappedBook::typeName(BookType type) {
+    switch (type) {
+        case BookType::Entero: return "entero";
+        case BookType::Decimal: return "decimal";
+        case BookType::Lista: return "lista";
+        default: return "texto";
+    }
+}
+
+// Tipo con el que se guarda un valor; lo que no es numero ni lista se guarda como texto
+BookType MappedBook::typeOf(const Value& value) {
+    switch (value.getType()) {
+        case ValueType::Entero: return BookType::Entero;
+        case ValueType::Decimal: return BookType::Decimal;
+        case ValueType::Lista: return BookType::Lista;
+        default: return BookType::Texto;
+    }
+}
+
+// Valor de un tipo del libro a partir de su texto; si no se puede leer queda como texto
+Value MappedBook::decode(BookType type, std::string_view text) {
+    switch (type) {
+        case BookType::Entero: {
+            long long number;
+            if (Utils::parseInteger(text, number)) return Value::fromInt(number);
+            break;
+        }
+        case BookType::Decimal: {
+            double number;
+            if (Utils::parseDecimal(text, number)) return Value::fromFloat(number);
+            break;
+        }
+        case BookType::Lista: {
+            std::vector<std::string> items;
+            for (std::string_view item : Utils::parseArray(text)) {
+                items.emplace_back(item);
+            }
+            return Value::fromList(std::move(items));
+        }
+        default:
+            break;
+    }
+    return Value::fromText(std::string(text));
+}
+
+// Decimal con todos sus digitos y siempre con punto, para leerlo igual de vuelta
+static void appendDecimal(double number, std::string& out) {
+    char buffer[400];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), number, std::chars_format::fixed);
+    std::string_view text(buffer, result.ec == std::errc() ? result.ptr - buffer : 0);
+    out += text;
+    if (text.find('.') == std::string_view::npos) out += ".0";
+}
+
+// Texto de un valor tal como se escribe en el libro
+std::string MappedBook::textOf(const Value& value) {
+    std::string text;
+    switch (value.getType()) {
+        case ValueType::Decimal:
+            appendDecimal(value.asFloat(), text);
+            return text;
+        case ValueType::Lista:
+            text += '[';
+            for (size_t i = 0; i < value.listSize(); i++) {
+                if (i > 0) text += ", ";
+                switch (value.listKind()) {
+                    case ListKind::Entero: Value::appendInt(value.listInts()[i], text); break;
+                    case ListKind::Decimal: appendDecimal(value.listFloats()[i], text); break;
+                    default: text += value.listText(i); break;
+                }
+            }
+            text += ']';
+            return text;
+        default:
+            return value.toString();
+    }
+}
+
+// Primera pasada por un libro de texto: solo anota donde esta cada clave y valor,
+// sin copiar nada. Los valores se leen despues, cuando se piden.
+void MappedBook::indexText(bool (*acceptKey)(std::string_view)) {
+    std::string_view bytes = file.view();
+    int lineNum = 0;
+    size_t position = 0;
+    
+    while (position < bytes.length()) {
+        size_t end = bytes.find('\n', position);
+        if (end == std::string_view::npos) end = bytes.length();
+        std::string_view line = bytes.substr(position, end - position);
+        position = end + 1;
+        // Un libro escrito en Windows termina cada linea en "\r\n"
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        std::string_view entry = Utils::trim(line);
+        lineNum++;
+        
+        if (entry.empty() || entry[0] == '#') continue;
+        
+        size_t firstColon = entry.find(':');
+        size_t secondColon = entry.find(':', firstColon + 1);
+        
+        if (firstColon == std::string_view::npos || secondColon == std::string_view::npos) {
+            std::cerr << "Advertencia: Línea " << lineNum << " formato incorrecto" << std::endl;
+            continue;
+        }
+        
+        std::string_view key = Utils::trim(entry.substr(0, firstColon));
+        std::string_view type = Utils::trim(entry.substr(firstColon + 1, secondColon - firstColon - 1));
+        std::string_view value = entry.substr(secondColon + 1);
+        
+        if (!acceptKey(key)) continue;
+        
+        if (type == "texto" && value.length() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.length() - 2);
+        }
+        entries.push_back({static_cast<uint64_t>(key.data() - bytes.data()), static_cast<uint64_t>(value.data() - bytes.data()),
+                           static_cast<uint32_t>(key.length()), static_cast<uint32_t>(value.length()), typeFromName(type)});
+    }
+    
+    // Un libro guardado por Pancracio ya viene ordenado y no hace falta ordenarlo
+    auto textKey = [&bytes](const TextEntry& entry) { return bytes.substr(entry.keyOffset, entry.keyLength); };
+    auto byKey = [&textKey](const TextEntry& a, const TextEntry& b) { return textKey(a) < textKey(b); };
+    if (!std::is_sorted(entries.begin(), entries.end(), byKey)) {
+        std::stable_sort(entries.begin(), entries.end(), byKey);
+    }
+    
+    // Con una clave repetida vale la ultima linea, como al cargarlas una tras otra
+    size_t kept = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (i + 1 < entries.size() && textKey(entries[i]) == textKey(entries[i + 1])) continue;
+        entries[kept++] = entries[i];
+    }
+    entries.resize(kept);
+    entries.shrink_to_fit();
+    count = entries.size();
+}
+
+// Busqueda binaria en el indice ordenado; -1 si la clave no esta
+long MappedBook::find(std::string_view key) const {
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        int order = keyAt(middle).compare(key);
+        if (order == 0) return static_cast<long>(middle);
+        if (order < 0) low = middle + 1;
+        else high = middle;
+    }
+    return -1;
+}
+
+// Valor con su tipo: del binario los numeros salen directos, del texto se decodifican
+Value MappedBook::valueAt(size_t position) const {
+    if (!binary) {
+        const TextEntry& entry = entries[position];
+        return decode(entry.type, file.view().substr(entry.valueOffset, entry.valueLength));
+    }
+    
+    const IndexEntry& entry = index[position];
+    const char* data = values + entry.valueOffset;
+    
+    switch (static_cast<BookType>(entry.type)) {
+        case BookType::Entero: {
+            int64_t number;
+            std::memcpy(&number, data, sizeof(number));
+            return Value::fromInt(static_cast<long long>(number));
+        }
+        case BookType::Decimal: {
+            double number;
+            std::memcpy(&number, data, sizeof(number));
+            return Value::fromFloat(number);
+        }
+        default:
+            return decode(static_cast<BookType>(entry.type), std::string_view(data, entry.valueLength));
+    }
+}
+
+void MappedBook::Writer::add(std::string_view key, const Value& value) {
+    IndexEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.keyOffset = keyBytes.length();
+    entry.keyLength = static_cast<uint32_t>(key.length());
+    keyBytes += key;
+    
+    BookType type = typeOf(value);
+    entry.type = static_cast<uint8_t>(type);
+    entry.valueOffset = valueBytes.length();
+    if (type == BookType::Entero) {
+        int64_t stored = value.asInt();
+        entry.valueLength = sizeof(stored);
+        valueBytes.append(reinterpret_cast<const char*>(&stored), sizeof(stored));
+    } else if (type == BookType::Decimal) {
+        double stored = value.asFloat();
+        entry.valueLength = sizeof(stored);
+        valueBytes.append(reinterpret_cast<const char*>(&stored), sizeof(stored));
+    } else {
+        std::string text = textOf(value);
+        entry.valueLength = static_cast<uint32_t>(text.length());
+        valueBytes += text;
+    }
+    entries.push_back(entry);
+}
+
+bool MappedBook::Writer::write(const std::string& path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo guardar el archivo " << path << std::endl;
+        return false;
+    }
+    
+    // Los valores empiezan alineados a 8 bytes
+    keyBytes.resize((keyBytes.length() + 7) & ~static_cast<size_t>(7), '\0');
+    
+    Header header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.count = static_cast<uint32_t>(entries.size());
+    header.keysOffset = sizeof(Header) + entries.size() * sizeof(IndexEntry);
+    header.valuesOffset = header.keysOffset + keyBytes.length();
+    
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(IndexEntry));
+    file.write(keyBytes.data(), keyBytes.length());
+    file.write(valueBytes.data(), valueBytes.length());
+    
+    if (!file) {
+        std::cerr << "Error: No se pudo guardar el archivo " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Cada registro: operacion, tipo, largo de clave y valor, clave, valor y suma de control
+static uint32_t checksum(const char* bytes, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 16777619u;
+    }
+    return hash;
+}
+
+void BookLog::attach(const std::string& bookPath) {
+    path = bookPath + ".log";
+    pending.clear();
+    std::error_code error;
+    uintmax_t bytes = std::filesystem::file_size(path, error);
+    fileSize = error ? 0 : static_cast<size_t>(bytes);
+}
+
+// Lee los registros completos; un final cortado (el programa se cerro a medias) se descarta
+std::vector<LogRecord> BookLog::replay() {
+    std::vector<LogRecord> records;
+    if (fileSize == 0) {
+        return records;
+    }
+    
+    MappedFile file;
+    if (!file.open(path)) {
+        return records;
+    }
+    std::string_view bytes = file.view();
+    
+    size_t position = 0;
+    const size_t headerSize = 2 + 2 * sizeof(uint32_t);
+    while (bytes.length() - position >= headerSize + sizeof(uint32_t)) {
+        const char* record = bytes.data() + position;
+        uint32_t keyLength;
+        uint32_t valueLength;
+        std::memcpy(&keyLength, record + 2, sizeof(keyLength));
+        std::memcpy(&valueLength, record + 2 + sizeof(keyLength), sizeof(valueLength));
+        
+        size_t bodyLength = headerSize + static_cast<size_t>(keyLength) + valueLength;
+        if (bytes.length() - position - sizeof(uint32_t) < bodyLength) break;
+        uint32_t stored;
+        std::memcpy(&stored, record + bodyLength, sizeof(stored));
+        if (stored != checksum(record, bodyLength) || static_cast<unsigned char>(record[0]) > static_cast<unsigned char>(LogOperation::Limpiar) ||
+            static_cast<unsigned char>(record[1]) > static_cast<unsigned char>(BookType::Lista)) break;
+        
+        const char* key = record + headerSize;
+        LogOperation operation = static_cast<LogOperation>(record[0]);
+        Value value;
+        if (operation == LogOperation::Escribir) {
+            value = MappedBook::decode(static_cast<BookType>(record[1]), std::string_view(key + keyLength, valueLength));
+        }
+        records.push_back({operation, std::string(key, keyLength), std::move(value)});
+        position += bodyLength + sizeof(uint32_t);
+    }
+    
+    file.close();
+    if (position < bytes.length()) {
+        std::cerr << "Advertencia: se descarto el final incompleto de " << path << std::endl;
+        std::error_code error;
+        std::filesystem::resize_file(path, position, error);
+        fileSize = position;
+    }
+    return records;
+}
+
+void BookLog::append(LogOperation operation, std::string_view key, const Value& value) {
+    size_t start = pending.length();
+    std::string text = value.isEmpty() ? std::string() : MappedBook::textOf(value);
+    uint32_t keyLength = static_cast<uint32_t>(key.length());
+    uint32_t valueLength = static_cast<uint32_t>(text.length());
+    
+    pending += static_cast<char>(operation);
+    pending += static_cast<char>(MappedBook::typeOf(value));
+    pending.append(reinterpret_cast<const char*>(&keyLength), sizeof(keyLength));
+    pending.append(reinterpret_cast<const char*>(&valueLength), sizeof(valueLength));
+    pending += key;
+    pending += text;
+    uint32_t sum = checksum(pending.data() + start, pending.length() - start);
+    pending.append(reinterpret_cast<const char*>(&sum), sizeof(sum));
+    
+    if (pending.length() >= GroupCommitBytes) {
+        flush();
+    }
+}
+
+// Escribe juntos todos los cambios pendientes y espera a que lleguen al disco
+bool BookLog::flush() {
+    if (pending.empty()) {
+        return true;
+    }
+    
+    std::FILE* file = std::fopen(path.c_str(), "ab");
+    if (!file) {
+        std::cerr << "Error: No se pudo escribir el registro " << path << std::endl;
+        return false;
+    }
+    bool written = std::fwrite(pending.data(), 1, pending.length(), file) == pending.length() && std::fflush(file) == 0;
+#ifdef _WIN32
+    written = written && _commit(_fileno(file)) == 0;
+#else
+    written = written && fsync(fileno(file)) == 0;
+#endif
+    std::fclose(file);
+    
+    if (!written) {
+        std::cerr << "Error: No se pudo escribir el registro " << path << std::endl;
+        return false;
+    }
+    fileSize += pending.length();
+    pending.clear();
+    return true;
+}
+
+// Tras un guardado completo los cambios ya estan en el libro
+void BookLog::discard() {
+    pending.clear();
+    if (fileSize > 0) {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+    fileSize = 0;
+}
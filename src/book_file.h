@@ -0,0 +1,144 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "value.h"
+
+enum class BookType : unsigned char { Entero, Decimal, Texto, Lista };
+
+// Archivo de solo lectura proyectado en memoria (mmap en POSIX, CreateFileMapping en Windows)
+class MappedFile {
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept : bytes(other.bytes), length(other.length) {
+        other.bytes = nullptr;
+        other.length = 0;
+    }
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return bytes != nullptr; }
+    std::string_view view() const { return std::string_view(bytes, length); }
+};
+
+// Libro .pansos abierto sin cargar sus valores: las claves se buscan en un indice
+// ordenado y cada valor se decodifica del archivo proyectado al pedirlo.
+// En un libro de texto el indice se arma al abrir con una sola pasada por las lineas.
+// El formato binario ya lo trae escrito:
+//   cabecera | indice de claves ordenado | claves | valores
+// Los enteros y decimales se guardan como 8 bytes (little-endian), los textos
+// y listas como sus bytes tal cual. Cada valor se lee ya con el tipo del libro.
+class MappedBook {
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t count;
+        uint64_t keysOffset;
+        uint64_t valuesOffset;
+    };
+    struct IndexEntry {
+        uint64_t keyOffset;
+        uint64_t valueOffset;
+        uint32_t keyLength;
+        uint32_t valueLength;
+        uint8_t type;
+        uint8_t reserved[7];
+    };
+    // Posiciones de una linea clave:tipo:valor dentro del archivo
+    struct TextEntry {
+        uint64_t keyOffset;
+        uint64_t valueOffset;
+        uint32_t keyLength;
+        uint32_t valueLength;
+        BookType type;
+    };
+    
+    static constexpr char Magic[8] = {'\x89', 'P', 'A', 'N', 'S', 'O', 'S', '\n'};
+    static constexpr uint32_t Version = 1;
+    
+    MappedFile file;
+    bool binary = false;
+    const IndexEntry* index = nullptr;
+    const char* keys = nullptr;
+    const char* values = nullptr;
+    std::vector<TextEntry> entries;
+    size_t count = 0;
+    
+    bool validate();
+    void indexText(bool (*acceptKey)(std::string_view));
+
+public:
+    // Arma un libro binario entrada por entrada; las claves deben llegar ordenadas
+    class Writer {
+    private:
+        std::vector<IndexEntry> entries;
+        std::string keyBytes;
+        std::string valueBytes;
+    
+    public:
+        void add(std::string_view key, const Value& value);
+        bool write(const std::string& path);
+    };
+    
+    static BookType typeOf(const Value& value);
+    static BookType typeFromName(std::string_view name);
+    static const char* typeName(BookType type);
+    static Value decode(BookType type, std::string_view text);
+    static std::string textOf(const Value& value);
+    
+    bool open(const std::string& path, bool (*acceptKey)(std::string_view));
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+    bool isBinary() const { return binary; }
+    
+    size_t size() const { return count; }
+    long find(std::string_view key) const;
+    std::string_view keyAt(size_t position) const {
+        if (binary) return std::string_view(keys + index[position].keyOffset, index[position].keyLength);
+        return std::string_view(file.view().data() + entries[position].keyOffset, entries[position].keyLength);
+    }
+    BookType typeAt(size_t position) const {
+        return binary ? static_cast<BookType>(index[position].type) : entries[position].type;
+    }
+    Value valueAt(size_t position) const;
+};
+
+enum class LogOperation : unsigned char { Escribir, Borrar, Limpiar };
+
+struct LogRecord {
+    LogOperation operation;
+    std::string key;
+    Value value;
+};
+
+// Registro de cambios de un libro (<libro>.log). Cada cambio se agrega al final
+// con el valor que queda y su tipo, asi aplicarlo dos veces da lo mismo. Los cambios se
+// juntan en memoria y se escriben de una vez al guardar o al llenarse el bufer.
+class BookLog {
+private:
+    std::string path;
+    std::string pending;
+    size_t fileSize = 0;
+
+public:
+    static constexpr size_t GroupCommitBytes = 64 * 1024;
+    
+    void attach(const std::string& bookPath);
+    std::vector<LogRecord> replay();
+    void append(LogOperation operation, std::string_view key, const Value& value = Value());
+    bool flush();
+    void discard();
+    
+    size_t size() const { return fileSize + pending.size(); }
+    bool hasPending() const { return !pending.empty(); }
+};
@@ -3,109 +3,242 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <filesystem>
 
-BookManager::BookManager() : isFileOpen(false) {}
+BookManager::BookManager() : isFileOpen(false), binaryFormat(false) {}
 
 BookManager::~BookManager() {
-    if (isFileOpen && !currentFile.empty()) {
+    // Un libro sin cambios desde el ultimo guardado no se vuelve a escribir
+    if (isFileOpen && !currentFile.empty() && generation != savedGeneration) {
         saveFile();
     }
 }
 
-std::string BookManager::parseValue(const std::string& line, const std::string& type) {
-    size_t colonPos = line.find_last_of(':');
-    if (colonPos == std::string::npos) return "";
-    
-    std::string value = line.substr(colonPos + 1);
-    
-    if (type == "texto") {
-        if (value.length() >= 2 && value.front() == '"' && value.back() == '"') {
-            return value.substr(1, value.length() - 2);
-        }
+// Un texto escrito en el libro toma el tipo que aparenta; se decide una sola vez, al escribirlo
+Value BookManager::typedValue(const Value& value) {
+    if (value.getType() == ValueType::Diccionario) {
+        return Value::fromText(value.toString());
     }
-    
-    return value;
-}
-
-std::string BookManager::formatValue(const std::string& value, const std::string& type) {
-    if (type == "texto") {
-        return "\"" + value + "\"";
+    if (value.getType() != ValueType::Texto) {
+        return value;
     }
-    return value;
-}
-
-std::string BookManager::detectType(const std::string& value) {
-    if (value.length() >= 2 && value.front() == '[' && value.back() == ']') {
-        return "lista";
+    
+    std::string_view text = value.asText();
+    if (text.length() >= 2 && text.front() == '[' && text.back() == ']') {
+        return MappedBook::decode(BookType::Lista, text);
     }
     
-    if (value.find('.') != std::string::npos) {
-        try {
-            std::stod(value);
-            return "decimal";
-        } catch (...) {}
+    double decimalValue;
+    if (text.find('.') != std::string::npos && Utils::parseDecimal(text, decimalValue)) {
+        return Value::fromFloat(decimalValue);
     }
     
-    try {
-        std::stoi(value);
-        return "entero";
-    } catch (...) {}
+    long long intValue;
+    if (Utils::parseInteger(text, intValue)) {
+        return Value::fromInt(intValue);
+    }
     
-    return "texto";
+    return value;
 }
 
-std::vector<std::string> BookManager::parseList(const std::string& listStr) {
+// Elementos de una lista del libro como textos sin comillas
+std::vector<std::string> BookManager::parseList(const Value& list) {
     std::vector<std::string> result;
-    if (listStr.length() < 2 || listStr.front() != '[' || listStr.back() != ']') {
+    if (list.getType() != ValueType::Lista) {
         return result;
     }
     
-    std::string content = listStr.substr(1, listStr.length() - 2);
-    std::stringstream ss(content);
-    std::string item;
-    
-    while (std::getline(ss, item, ',')) {
-        item = Utils::trim(item);
+    for (size_t i = 0; i < list.listSize(); i++) {
+        std::string item = list.listKind() == ListKind::Texto ? list.listText(i) : MappedBook::textOf(list.listItem(i));
         if (item.length() >= 2 && item.front() == '"' && item.back() == '"') {
             item = item.substr(1, item.length() - 2);
         }
         if (!item.empty()) {
-            result.push_back(item);
+            result.push_back(std::move(item));
         }
     }
     
     return result;
 }
 
-std::string BookManager::formatList(const std::vector<std::string>& list) {
-    std::string result = "[";
-    for (size_t i = 0; i < list.size(); i++) {
-        if (i > 0) result += ", ";
-        result += "\"" + list[i] + "\"";
+Value BookManager::formatList(const std::vector<std::string>& list) {
+    std::vector<std::string> items;
+    items.reserve(list.size());
+    for (const std::string& item : list) {
+        items.push_back("\"" + item + "\"");
     }
-    result += "]";
-    return result;
+    return Value::fromList(std::move(items));
+}
+
+// Busca primero en los cambios y despues en el libro binario
+bool BookManager::lookup(const std::string& key, Value& value) {
+    auto it = data.find(key);
+    if (it != data.end()) {
+        value = it->second;
+        return true;
+    }
+    if (!base.isOpen() || removed.count(key) > 0) {
+        return false;
+    }
+    
+    long position = base.find(key);
+    if (position < 0) {
+        return false;
+    }
+    // El valor leido queda guardado para la proxima vez
+    value = data.emplace(key, base.valueAt(position)).first->second;
+    return true;
+}
+
+// Recorre las entradas validas ordenadas por clave, mezclando el libro abierto con
+// los cambios sin copiarlas; devuelve cuantas visito
+template <typename Visit>
+size_t BookManager::forEachEntry(Visit visit) {
+    size_t count = 0;
+    auto changed = data.begin();
+    for (size_t i = 0; i < base.size(); i++) {
+        std::string_view key = base.keyAt(i);
+        for (; changed != data.end() && changed->first < key; ++changed) {
+            if (isValidKey(changed->first)) {
+                visit(changed->first, changed->second);
+                count++;
+            }
+        }
+        if (changed != data.end() && changed->first == key) {
+            continue;
+        }
+        
+        if ((removed.empty() || removed.count(std::string(key)) == 0) && isValidKey(key)) {
+            visit(key, base.valueAt(i));
+            count++;
+        }
+    }
+    for (; changed != data.end(); ++changed) {
+        if (isValidKey(changed->first)) {
+            visit(changed->first, changed->second);
+            count++;
+        }
+    }
+    
+    return count;
 }
 
-bool BookManager::isValidKey(const std::string& key) {
+// Entradas del libro sin recorrerlo: las de la base que siguen vivas mas las nuevas
+size_t BookManager::entryCount() const {
+    size_t count = data.size();
+    if (base.isOpen()) {
+        count += base.size() - removed.size();
+        for (const auto& [key, value] : data) {
+            if (removed.count(key) == 0 && base.find(key) >= 0) count--;
+        }
+    }
+    return count;
+}
+
+void BookManager::setEntry(const std::string& key, Value value) {
+    data[key] = std::move(value);
+}
+
+bool BookManager::eraseEntry(const std::string& key) {
+    bool found = data.erase(key) > 0;
+    if (base.isOpen() && base.find(key) >= 0 && removed.insert(key).second) {
+        found = true;
+    }
+    return found;
+}
+
+void BookManager::clearEntries() {
+    data.clear();
+    base.close();
+    removed.clear();
+}
+
+// Aplica los cambios que quedaron en el registro desde el ultimo guardado completo
+void BookManager::replayLog() {
+    for (const LogRecord& record : log.replay()) {
+        switch (record.operation) {
+            case LogOperation::Escribir: setEntry(record.key, record.value); break;
+            case LogOperation::Borrar: eraseEntry(record.key); break;
+            case LogOperation::Limpiar: clearEntries(); break;
+        }
+    }
+}
+
+void BookManager::markDirty(const std::string& key) {
+    dirtyKeys.insert(key);
+    generation++;
+    if (dirtyKeys.size() >= GroupCommitKeys) {
+        flushChanges();
+    }
+}
+
+void BookManager::markCleared() {
+    dirtyKeys.clear();
+    clearedSinceFlush = true;
+    generation++;
+}
+
+// Todo lo cambiado ya esta en disco
+void BookManager::markSaved() {
+    dirtyKeys.clear();
+    clearedSinceFlush = false;
+    savedGeneration = generation;
+}
+
+// Agrega al registro el valor actual de cada clave cambiada: varios cambios
+// a la misma clave entre dos guardados quedan en un solo registro, y una
+// clave que ya no esta queda como borrada
+bool BookManager::flushChanges() {
+    if (clearedSinceFlush) {
+        log.append(LogOperation::Limpiar, "");
+    }
+    
+    Value value;
+    for (const std::string& key : dirtyKeys) {
+        if (lookup(key, value)) {
+            log.append(LogOperation::Escribir, key, value);
+        } else {
+            log.append(LogOperation::Borrar, key);
+        }
+    }
+    dirtyKeys.clear();
+    clearedSinceFlush = false;
+    return log.flush();
+}
+
+static size_t fileSizeOf(const std::string& path) {
+    std::error_code error;
+    uintmax_t bytes = std::filesystem::file_size(path, error);
+    return error ? 0 : static_cast<size_t>(bytes);
+}
+
+bool BookManager::isValidKey(std::string_view key) {
     // ARREGLO CRÍTICO: Permitir claves válidas que terminan en "_hobbies"
     if (key.empty()) return false;
     
     // Rechazar claves específicamente problemáticas
     if (key == "lingan" || key == "manolo perez") return false;
-    if (key.find(' ') != std::string::npos && key.find("perez") != std::string::npos) return false;
+    if (key.find(' ') != std::string_view::npos && key.find("perez") != std::string_view::npos) return false;
     
     // PERMITIR claves como "juan_hobbies", "maria_hobbies", etc.
     return true;
 }
 
+bool BookManager::acceptLoadedKey(std::string_view key) {
+    if (isValidKey(key)) {
+        return true;
+    }
+    std::cout << "Ignorando entrada problemática: " << key << std::endl;
+    return false;
+}
+
 bool BookManager::createFile(const std::string& filename) {
     std::string fullPath = filename;
     if (fullPath.find(".pansos") == std::string::npos) {
         fullPath += ".pansos";
     }
     
-    std::ofstream file(fullPath);
+    std::ofstream file(fullPath, std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "Error: No se pudo crear el archivo " << fullPath << std::endl;
         return false;
@@ -118,7 +251,14 @@ bool BookManager::createFile(const std::string& filename) {
     
     currentFile = fullPath;
     isFileOpen = true;
+    binaryFormat = false;
     data.clear();
+    base.close();
+    removed.clear();
+    log.attach(fullPath);
+    log.discard();
+    bookBytes = fileSizeOf(fullPath);
+    markSaved();
     
     std::cout << "Archivo '" << fullPath << "' creado exitosamente" << std::endl;
     return true;
@@ -130,49 +270,24 @@ bool BookManager::openFile(const std::string& filename) {
         fullPath += ".pansos";
     }
     
-    std::ifstream file(fullPath);
-    if (!file.is_open()) {
-        std::cerr << "Error: No se pudo abrir el archivo " << fullPath << std::endl;
+    // Solo se arma el indice de claves; los valores se leen del archivo al pedirlos
+    MappedBook opened;
+    if (!opened.open(fullPath, acceptLoadedKey)) {
         return false;
     }
-    
+    base = std::move(opened);
     data.clear();
-    std::string line;
-    int lineNum = 0;
-    int validEntries = 0;
-    
-    while (std::getline(file, line)) {
-        lineNum++;
-        line = Utils::trim(line);
-        
-        if (line.empty() || line[0] == '#') continue;
-        
-        size_t firstColon = line.find(':');
-        size_t secondColon = line.find(':', firstColon + 1);
-        
-        if (firstColon == std::string::npos || secondColon == std::string::npos) {
-            std::cerr << "Advertencia: Línea " << lineNum << " formato incorrecto" << std::endl;
-            continue;
-        }
-        
-        std::string key = Utils::trim(line.substr(0, firstColon));
-        std::string type = Utils::trim(line.substr(firstColon + 1, secondColon - firstColon - 1));
-        std::string value = parseValue(line, type);
-        
-        if (!isValidKey(key)) {
-            std::cout << "Ignorando entrada problemática: " << key << std::endl;
-            continue;
-        }
-        
-        data[key] = value;
-        validEntries++;
-    }
+    removed.clear();
+    binaryFormat = base.isBinary();
     
-    file.close();
     currentFile = fullPath;
     isFileOpen = true;
+    bookBytes = fileSizeOf(fullPath);
+    log.attach(fullPath);
+    replayLog();
+    markSaved();
     
-    std::cout << "Archivo '" << fullPath << "' abierto exitosamente (" << validEntries << " entradas válidas cargadas)" << std::endl;
+    std::cout << "Archivo '" << fullPath << "' abierto exitosamente (" << entryCount() << " entradas válidas cargadas)" << std::endl;
     return true;
 }
 
@@ -188,9 +303,65 @@ bool BookManager::saveFile(const std::string& filename) {
         saveFile += ".pansos";
     }
     
-    std::ofstream file(saveFile);
+    // Guardar el mismo libro solo agrega los cambios al registro, hasta que este crece demasiado
+    if (saveFile == currentFile) {
+        if (!flushChanges()) {
+            return false;
+        }
+        if (log.size() <= std::max(CheckpointBytes, bookBytes / 4)) {
+            savedGeneration = generation;
+            std::cout << "Archivo guardado exitosamente: " << saveFile << " (" << entryCount() << " entradas válidas)" << std::endl;
+            return true;
+        }
+    }
+    
+    return writeBook(saveFile);
+}
+
+// Escribe el libro completo y deja el registro vacio
+bool BookManager::writeBook(const std::string& saveFile) {
+    // Un libro proyectado no se puede sobrescribir: se escribe aparte y se reemplaza
+    bool mapped = base.isOpen();
+    std::string writePath = mapped ? saveFile + ".tmp" : saveFile;
+    size_t count = 0;
+    bool written = binaryFormat ? writeBinary(writePath, count) : writeText(writePath, count);
+    if (!written) {
+        return false;
+    }
+    
+    if (mapped) {
+        base.close();
+        std::error_code error;
+        std::filesystem::rename(writePath, saveFile, error);
+        if (error) {
+            std::cerr << "Error: No se pudo guardar el archivo " << saveFile << std::endl;
+            base.open(currentFile, acceptLoadedKey);
+            return false;
+        }
+    }
+    
+    // Lo guardado pasa a ser la base y no quedan cambios pendientes
+    data.clear();
+    removed.clear();
+    if (!base.open(saveFile, acceptLoadedKey)) {
+        isFileOpen = false;
+        return false;
+    }
+    
+    currentFile = saveFile;
+    log.attach(saveFile);
+    log.discard();
+    bookBytes = fileSizeOf(saveFile);
+    markSaved();
+    
+    std::cout << "Archivo guardado exitosamente: " << saveFile << " (" << count << " entradas válidas)" << std::endl;
+    return true;
+}
+
+bool BookManager::writeText(const std::string& path, size_t& count) {
+    std::ofstream file(path, std::ios::binary);
     if (!file.is_open()) {
-        std::cerr << "Error: No se pudo guardar el archivo " << saveFile << std::endl;
+        std::cerr << "Error: No se pudo guardar el archivo " << path << std::endl;
         return false;
     }
     
@@ -198,33 +369,54 @@ bool BookManager::saveFile(const std::string& filename) {
     file << "# Formato: clave:tipo:valor\n";
     file << "# Tipos soportados: entero, decimal, texto, lista\n\n";
     
-    // Solo guardar entradas válidas y ordenarlas
-    std::vector<std::pair<std::string, std::string>> validData;
-    for (const auto& [key, value] : data) {
-        if (isValidKey(key)) {
-            validData.push_back({key, value});
+    count = forEachEntry([&file](std::string_view key, const Value& value) {
+        BookType type = MappedBook::typeOf(value);
+        file << key << ":" << MappedBook::typeName(type) << ":";
+        if (type == BookType::Texto) {
+            file << "\"" << MappedBook::textOf(value) << "\"\n";
+        } else {
+            file << MappedBook::textOf(value) << "\n";
         }
-    }
+    });
     
-    std::sort(validData.begin(), validData.end());
-    
-    for (const auto& [key, value] : validData) {
-        std::string type = detectType(value);
-        std::string formattedValue = formatValue(value, type);
-        file << key << ":" << type << ":" << formattedValue << "\n";
+    return true;
+}
+
+bool BookManager::writeBinary(const std::string& path, size_t& count) {
+    MappedBook::Writer writer;
+    count = forEachEntry([&writer](std::string_view key, const Value& value) { writer.add(key, value); });
+    return writer.write(path);
+}
+
+// Convierte un libro entre el formato de texto y el binario
+bool BookManager::convertFile(const std::string& source, const std::string& target, bool toBinary) {
+    if (!openFile(source)) {
+        return false;
     }
-    
-    file.close();
-    
-    if (!filename.empty()) {
-        currentFile = saveFile;
+    std::string fullPath = target;
+    if (fullPath.find(".pansos") == std::string::npos) {
+        fullPath += ".pansos";
     }
     
-    std::cout << "Archivo guardado exitosamente: " << saveFile << " (" << validData.size() << " entradas válidas)" << std::endl;
-    return true;
+    binaryFormat = toBinary;
+    bool saved = writeBook(fullPath);
+    close();
+    return saved;
+}
+
+// Cierra el libro sin guardarlo
+void BookManager::close() {
+    base.close();
+    data.clear();
+    removed.clear();
+    log = BookLog();
+    markSaved();
+    currentFile.clear();
+    isFileOpen = false;
+    binaryFormat = false;
 }
 
-void BookManager::writeData(const std::string& key, const std::string& value) {
+void BookManager::writeData(const std::string& key, const Value& value) {
     if (!isFileOpen) {
         std::cerr << "Error: No hay archivo abierto" << std::endl;
         return;
@@ -235,24 +427,34 @@ void BookManager::writeData(const std::string& key, const std::string& value) {
         return;
     }
     
-    data[key] = value;
-    std::cout << "Dato escrito: " << key << " = " << value << std::endl;
+    Value stored = typedValue(value);
+    std::string text = MappedBook::textOf(stored);
+    setEntry(key, std::move(stored));
+    markDirty(key);
+    std::cout << "Dato escrito: " << key << " = " << text << std::endl;
 }
 
 std::string BookManager::readData(const std::string& key) {
-    if (!isFileOpen) {
+    Value value;
+    if (!readValue(key, value)) {
         return "";
     }
-    
-    auto it = data.find(key);
-    if (it != data.end()) {
-        return it->second;
-    }
-    return "";
+    return MappedBook::textOf(value);
+}
+
+// Valor con el tipo que tiene en el libro
+bool BookManager::readValue(const std::string& key, Value& value) {
+    return isFileOpen && lookup(key, value);
 }
 
 bool BookManager::existsKey(const std::string& key) {
-    return isFileOpen && data.find(key) != data.end();
+    if (!isFileOpen) {
+        return false;
+    }
+    if (data.find(key) != data.end()) {
+        return true;
+    }
+    return base.isOpen() && removed.count(key) == 0 && base.find(key) >= 0;
 }
 
 void BookManager::deleteKey(const std::string& key) {
@@ -261,9 +463,8 @@ void BookManager::deleteKey(const std::string& key) {
         return;
     }
     
-    auto it = data.find(key);
-    if (it != data.end()) {
-        data.erase(it);
+    if (eraseEntry(key)) {
+        markDirty(key);
         std::cout << "Clave '" << key << "' eliminada" << std::endl;
     } else {
         std::cout << "Clave '" << key << "' no encontrada" << std::endl;
@@ -283,13 +484,14 @@ void BookManager::addToList(const std::string& key, const std::string& value) {
     
     std::vector<std::string> list;
     
-    auto it = data.find(key);
-    if (it != data.end()) {
-        list = parseList(it->second);
+    Value current;
+    if (lookup(key, current)) {
+        list = parseList(current);
     }
     
     list.push_back(value);
-    data[key] = formatList(list);
+    setEntry(key, formatList(list));
+    markDirty(key);
     
     std::cout << "Elemento '" << value << "' agregado a la lista '" << key << "'" << std::endl;
 }
@@ -300,18 +502,19 @@ void BookManager::removeFromList(const std::string& key, const std::string& valu
         return;
     }
     
-    auto it = data.find(key);
-    if (it == data.end()) {
+    Value current;
+    if (!lookup(key, current)) {
         std::cout << "Lista '" << key << "' no encontrada" << std::endl;
         return;
     }
     
-    std::vector<std::string> list = parseList(it->second);
+    std::vector<std::string> list = parseList(current);
     auto listIt = std::find(list.begin(), list.end(), value);
     
     if (listIt != list.end()) {
         list.erase(listIt);
-        data[key] = formatList(list);
+        setEntry(key, formatList(list));
+        markDirty(key);
         std::cout << "Elemento '" << value << "' eliminado de la lista '" << key << "'" << std::endl;
     } else {
         std::cout << "Elemento '" << value << "' no encontrado en la lista '" << key << "'" << std::endl;
@@ -324,18 +527,19 @@ void BookManager::removeFromListByIndex(const std::string& key, int index) {
         return;
     }
     
-    auto it = data.find(key);
-    if (it == data.end()) {
+    Value current;
+    if (!lookup(key, current)) {
         std::cout << "Lista '" << key << "' no encontrada" << std::endl;
         return;
     }
     
-    std::vector<std::string> list = parseList(it->second);
+    std::vector<std::string> list = parseList(current);
     
     if (index >= 0 && index < static_cast<int>(list.size())) {
         std::string removedValue = list[index];
         list.erase(list.begin() + index);
-        data[key] = formatList(list);
+        setEntry(key, formatList(list));
+        markDirty(key);
         std::cout << "Elemento '" << removedValue << "' (índice " << index << ") eliminado de la lista '" << key << "'" << std::endl;
     } else {
         std::cout << "Índice " << index << " fuera de rango para la lista '" << key << "'" << std::endl;
@@ -348,27 +552,22 @@ void BookManager::listAll() {
         return;
     }
     
-    if (data.empty()) {
-        std::cout << "El archivo está vacío" << std::endl;
-        return;
-    }
-    
-    std::cout << "=== Contenido del archivo " << currentFile << " ===" << std::endl;
-    
-    std::vector<std::pair<std::string, std::string>> validData;
-    for (const auto& [key, value] : data) {
-        if (isValidKey(key)) {
-            validData.push_back({key, value});
+    // La cabecera sale con la primera entrada: un libro vacio no la lleva
+    const std::string& file = currentFile;
+    bool first = true;
+    size_t count = forEachEntry([&file, &first](std::string_view key, const Value& value) {
+        if (first) {
+            std::cout << "=== Contenido del archivo " << file << " ===" << std::endl;
+            first = false;
         }
-    }
+        std::cout << key << " (" << MappedBook::typeName(MappedBook::typeOf(value)) << "): " << MappedBook::textOf(value) << "\n";
+    });
     
-    std::sort(validData.begin(), validData.end());
-    
-    for (const auto& [key, value] : validData) {
-        std::string type = detectType(value);
-        std::cout << key << " (" << type << "): " << value << std::endl;
+    if (count == 0) {
+        std::cout << "El archivo está vacío" << std::endl;
+        return;
     }
-    std::cout << "=== Total: " << validData.size() << " entradas válidas ===" << std::endl;
+    std::cout << "=== Total: " << count << " entradas válidas ===" << std::endl;
 }
 
 void BookManager::clearAll() {
@@ -377,6 +576,7 @@ void BookManager::clearAll() {
         return;
     }
     
-    data.clear();
+    clearEntries();
+    markCleared();
     std::cout << "Todos los datos han sido eliminados del archivo" << std::endl;
 }
\ No newline at end of file
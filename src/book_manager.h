@@ -1,21 +1,53 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <map>
+#include <unordered_set>
 #include <vector>
 #include <fstream>
+#include <cstdint>
+#include "book_file.h"
 
 class BookManager {
 private:
     std::string currentFile;
-    std::map<std::string, std::string> data;
+    std::map<std::string, Value> data;           // valores ya leidos o cambiados, con su tipo
     bool isFileOpen;
+    bool binaryFormat;
+    MappedBook base;                              // libro abierto, sus valores se leen al pedirlos
+    std::unordered_set<std::string> removed;     // claves del libro abierto ya borradas
+    BookLog log;                                  // cambios desde el ultimo guardado completo
+    size_t bookBytes = 0;                         // tamano del libro en disco
+    std::unordered_set<std::string> dirtyKeys;   // claves cambiadas que aun no estan en el registro
+    bool clearedSinceFlush = false;
+    uint64_t generation = 0;                      // sube con cada cambio
+    uint64_t savedGeneration = 0;                 // generacion del ultimo guardado
     
-    std::string parseValue(const std::string& line, const std::string& type);
-    std::string formatValue(const std::string& value, const std::string& type);
-    std::string detectType(const std::string& value);
-    std::vector<std::string> parseList(const std::string& listStr);
-    std::string formatList(const std::vector<std::string>& list);
-    bool isValidKey(const std::string& key);
+    // El registro se vuelca en el libro cuando supera este tamano o la cuarta parte del libro
+    static constexpr size_t CheckpointBytes = 1024 * 1024;
+    // Con tantas claves cambiadas se escriben en el registro sin esperar a guardar
+    static constexpr size_t GroupCommitKeys = 4096;
+    
+    bool lookup(const std::string& key, Value& value);
+    size_t entryCount() const;
+    void setEntry(const std::string& key, Value value);
+    bool eraseEntry(const std::string& key);
+    void clearEntries();
+    void replayLog();
+    void markDirty(const std::string& key);
+    void markCleared();
+    void markSaved();
+    bool flushChanges();
+    bool writeBook(const std::string& path);
+    template <typename Visit>
+    size_t forEachEntry(Visit visit);
+    bool writeText(const std::string& path, size_t& count);
+    bool writeBinary(const std::string& path, size_t& count);
+    static Value typedValue(const Value& value);
+    std::vector<std::string> parseList(const Value& list);
+    Value formatList(const std::vector<std::string>& list);
+    static bool isValidKey(std::string_view key);
+    static bool acceptLoadedKey(std::string_view key);
 
 public:
     BookManager();
@@ -25,10 +57,13 @@ public:
     bool createFile(const std::string& filename);
     bool openFile(const std::string& filename);
     bool saveFile(const std::string& filename = "");
+    bool convertFile(const std::string& source, const std::string& target, bool toBinary);
+    void close();
     
     // Operaciones de datos
-    void writeData(const std::string& key, const std::string& value);
+    void writeData(const std::string& key, const Value& value);
     std::string readData(const std::string& key);
+    bool readValue(const std::string& key, Value& value);
     bool existsKey(const std::string& key);
     void deleteKey(const std::string& key);
     
@@ -0,0 +1,311 @@
+#include "builtin_table.h"
+#include "expressions.h"
+#include "list_operations.h"
+#include "dictionary.h"
+#include <iostream>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+// ---- Entrada, azar y teclado ----
+
+static Value aleatorio(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    return Value::fromInt(evaluator.randomGenerator().nextInt(args[0].toInt(), args[1].toInt()));
+}
+
+// Sin argumentos da un decimal en [0, 1)
+static Value aleatorioDecimal(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    double min = args.size() > 0 ? args[0].toFloat() : 0.0;
+    double max = args.size() > 1 ? args[1].toFloat() : 1.0;
+    return Value::fromFloat(evaluator.randomGenerator().nextDouble(min, max));
+}
+
+// aleatorio_lista(n, min, max): enteros, o decimales si algun limite es decimal
+static Value aleatorioLista(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    long long count = args[0].toInt();
+    if (count < 0) {
+        std::cerr << "Error: aleatorio_lista necesita un largo positivo" << std::endl;
+        return Value::fromIntList({});
+    }
+    
+    if (args[1].getType() == ValueType::Decimal || args[2].getType() == ValueType::Decimal) {
+        std::vector<double> items(count);
+        evaluator.randomGenerator().fillDoubles(items.data(), items.size(), args[1].toFloat(), args[2].toFloat());
+        return Value::fromFloatList(std::move(items));
+    }
+    std::vector<long long> items(count);
+    evaluator.randomGenerator().fillInts(items.data(), items.size(), args[1].toInt(), args[2].toInt());
+    return Value::fromIntList(std::move(items));
+}
+
+static Value tecla(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    return Value::fromInt(evaluator.isKeyPressed(args[0].toString()) ? 1 : 0);
+}
+
+static void showPrompt(const BuiltinArgs& args, const char* fallback) {
+    std::string prompt = args.size() > 0 ? args[0].toString() : "";
+    std::cout << (prompt.empty() ? fallback : prompt);
+}
+
+static Value pedirNumero(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    showPrompt(args, "Ingrese un numero: ");
+    
+    int num;
+    while (!(std::cin >> num)) {
+        std::cout << "Error: Ingrese un numero valido: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    std::cin.ignore();
+    return Value::fromInt(num);
+}
+
+static Value pedirNombre(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    showPrompt(args, "Ingrese un texto: ");
+    
+    std::string nombre;
+    std::getline(std::cin, nombre);
+    return Value::fromText(nombre);
+}
+
+// ---- Listas y diccionarios ----
+
+static Value largo(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    switch (args[0].getType()) {
+        case ValueType::Lista: return Value::fromInt(args[0].listSize());
+        case ValueType::Texto: return Value::fromInt(args[0].asText().length());
+        case ValueType::Diccionario: return Value::fromInt(args[0].asDictionary().size());
+        default: return Value::fromInt(0);
+    }
+}
+
+static bool requireList(const BuiltinArgs& args, const char* name) {
+    if (args[0].getType() == ValueType::Lista) return true;
+    std::cerr << "Error: " << name << " necesita una lista" << std::endl;
+    return false;
+}
+
+static Value ordenar(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    return requireList(args, "ordenar") ? ListOperations::sort(args[0], false) : Value();
+}
+
+static Value ordenarDesc(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    return requireList(args, "ordenar_desc") ? ListOperations::sort(args[0], true) : Value();
+}
+
+static Value unicos(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    return requireList(args, "unicos") ? ListOperations::unique(args[0]) : Value();
+}
+
+static Value buscar(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    return requireList(args, "buscar") ? Value::fromInt(ListOperations::find(args[0], args[1])) : Value();
+}
+
+static Value contiene(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    if (args[0].getType() == ValueType::Diccionario) {
+        return Value::fromInt(args[0].asDictionary().find(args[1].toString()) ? 1 : 0);
+    }
+    if (!requireList(args, "contiene")) return Value();
+    return Value::fromInt(ListOperations::find(args[0], args[1]) >= 0 ? 1 : 0);
+}
+
+static Value claves(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    if (args[0].getType() != ValueType::Diccionario) {
+        std::cerr << "Error: claves necesita un diccionario" << std::endl;
+        return Value();
+    }
+    return ExpressionEvaluator::keysOf(args[0]);
+}
+
+// ---- Listas numericas ----
+
+static Value escalar(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    if (!args[0].isNumericList()) {
+        std::cerr << "Error: escalar necesita una lista de numeros" << std::endl;
+        return Value::fromIntList({});
+    }
+    return ExpressionEvaluator::elementwise(KernelOp::Multiplicar, args[0], args[1]);
+}
+
+enum class Reduction { Suma, Promedio, Minimo, Maximo };
+
+// Sobre una lista numerica usa los nucleos SIMD; con una lista de textos o
+// varios numeros sueltos recorre los elementos uno a uno
+static Value reduce(Reduction reduction, const BuiltinArgs& args) {
+    if (args.size() == 1 && args[0].isNumericList()) {
+        const Value& list = args[0];
+        size_t count = list.listSize();
+        if (count == 0) return Value::fromInt(0);
+        
+        if (list.listKind() == ListKind::Entero) {
+            const long long* data = list.listInts();
+            switch (reduction) {
+                case Reduction::Suma: return Value::fromInt(NumericKernels::sumInt(data, count));
+                case Reduction::Minimo: return Value::fromInt(NumericKernels::minInt(data, count));
+                case Reduction::Maximo: return Value::fromInt(NumericKernels::maxInt(data, count));
+                default: return Value::fromFloat(static_cast<double>(NumericKernels::sumInt(data, count)) / count);
+            }
+        }
+        const double* data = list.listFloats();
+        switch (reduction) {
+            case Reduction::Suma: return Value::fromFloat(NumericKernels::sumFloat(data, count));
+            case Reduction::Minimo: return Value::fromFloat(NumericKernels::minFloat(data, count));
+            case Reduction::Maximo: return Value::fromFloat(NumericKernels::maxFloat(data, count));
+            default: return Value::fromFloat(NumericKernels::sumFloat(data, count) / count);
+        }
+    }
+    
+    std::vector<Value> items;
+    if (args.size() == 1 && args[0].getType() == ValueType::Lista) {
+        for (size_t i = 0; i < args[0].listSize(); i++) {
+            items.push_back(args[0].listItem(i));
+        }
+    } else {
+        for (size_t i = 0; i < args.size(); i++) {
+            items.push_back(args[i]);
+        }
+    }
+    if (items.empty()) return Value::fromInt(0);
+    
+    bool allInts = true;
+    long long intTotal = 0;
+    double floatTotal = 0.0;
+    const Value* best = &items[0];
+    for (const Value& item : items) {
+        if (item.getType() == ValueType::Decimal) allInts = false;
+        intTotal += item.toInt();
+        floatTotal += item.toFloat();
+        if (reduction == Reduction::Minimo && item.toFloat() < best->toFloat()) best = &item;
+        if (reduction == Reduction::Maximo && item.toFloat() > best->toFloat()) best = &item;
+    }
+    
+    switch (reduction) {
+        case Reduction::Suma: return allInts ? Value::fromInt(intTotal) : Value::fromFloat(floatTotal);
+        case Reduction::Promedio: return Value::fromFloat(floatTotal / items.size());
+        default:
+            return best->getType() == ValueType::Decimal ? Value::fromFloat(best->asFloat()) : Value::fromInt(best->toInt());
+    }
+}
+
+static Value suma(ExpressionEvaluator& evaluator, const BuiltinArgs& args) { return reduce(Reduction::Suma, args); }
+static Value promedio(ExpressionEvaluator& evaluator, const BuiltinArgs& args) { return reduce(Reduction::Promedio, args); }
+static Value minimo(ExpressionEvaluator& evaluator, const BuiltinArgs& args) { return reduce(Reduction::Minimo, args); }
+static Value maximo(ExpressionEvaluator& evaluator, const BuiltinArgs& args) { return reduce(Reduction::Maximo, args); }
+
+// ---- Matematicas ----
+
+static Value raiz(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    double x = args[0].toFloat();
+    if (x < 0.0) {
+        std::cerr << "Error: Raiz de un numero negativo" << std::endl;
+        return Value::fromFloat(0.0);
+    }
+    return Value::fromFloat(std::sqrt(x));
+}
+
+// Entero elevado a entero no negativo sigue siendo entero
+static Value potencia(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    if (args[0].getType() != ValueType::Decimal && args[1].getType() != ValueType::Decimal && args[1].toInt() >= 0) {
+        long long base = args[0].toInt();
+        long long result = 1;
+        for (long long exponent = args[1].toInt(); exponent > 0; exponent >>= 1) {
+            if (exponent & 1) result *= base;
+            base *= base;
+        }
+        return Value::fromInt(result);
+    }
+    return Value::fromFloat(std::pow(args[0].toFloat(), args[1].toFloat()));
+}
+
+static Value absoluto(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    if (args[0].getType() == ValueType::Decimal) return Value::fromFloat(std::fabs(args[0].asFloat()));
+    long long x = args[0].toInt();
+    return Value::fromInt(x < 0 ? -x : x);
+}
+
+static Value seno(ExpressionEvaluator& evaluator, const BuiltinArgs& args) { return Value::fromFloat(std::sin(args[0].toFloat())); }
+static Value coseno(ExpressionEvaluator& evaluator, const BuiltinArgs& args) { return Value::fromFloat(std::cos(args[0].toFloat())); }
+static Value tangente(ExpressionEvaluator& evaluator, const BuiltinArgs& args) { return Value::fromFloat(std::tan(args[0].toFloat())); }
+static Value pi(ExpressionEvaluator& evaluator, const BuiltinArgs& args) { return Value::fromFloat(3.14159265358979323846); }
+
+static Value logaritmo(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    double x = args[0].toFloat();
+    if (x <= 0.0) {
+        std::cerr << "Error: Logaritmo de un numero no positivo" << std::endl;
+        return Value::fromFloat(0.0);
+    }
+    return Value::fromFloat(std::log(x));
+}
+
+// redondear(x) da un entero; redondear(x, n) deja n decimales
+static Value redondear(ExpressionEvaluator& evaluator, const BuiltinArgs& args) {
+    double x = args[0].toFloat();
+    if (args.size() < 2) return Value::fromInt(std::llround(x));
+    double scale = std::pow(10.0, static_cast<double>(args[1].toInt()));
+    return Value::fromFloat(std::round(x * scale) / scale);
+}
+
+static Value piso(ExpressionEvaluator& evaluator, const BuiltinArgs& args) { return Value::fromInt(static_cast<long long>(std::floor(args[0].toFloat()))); }
+static Value techo(ExpressionEvaluator& evaluator, const BuiltinArgs& args) { return Value::fromInt(static_cast<long long>(std::ceil(args[0].toFloat()))); }
+
+static void registerBuiltins() {
+    const size_t many = BuiltinArgs::Max;
+    
+    BuiltinTable::registerFunction("aleatorio", 2, 2, BuiltinResult::Numero, aleatorio);
+    BuiltinTable::registerFunction("aleatorio_decimal", 0, 2, BuiltinResult::Numero, aleatorioDecimal);
+    BuiltinTable::registerFunction("aleatorio_lista", 3, 3, BuiltinResult::ListaNumerica, aleatorioLista);
+    BuiltinTable::registerFunction("tecla", 1, 1, BuiltinResult::Numero, tecla);
+    BuiltinTable::registerFunction("pedir_numero", 0, 1, BuiltinResult::Numero, pedirNumero);
+    BuiltinTable::registerFunction("pedir_nombre", 0, 1, BuiltinResult::Texto, pedirNombre);
+    
+    BuiltinTable::registerFunction("largo", 1, 1, BuiltinResult::Numero, largo);
+    BuiltinTable::registerFunction("ordenar", 1, 1, BuiltinResult::ComoPrimerArgumento, ordenar);
+    BuiltinTable::registerFunction("ordenar_desc", 1, 1, BuiltinResult::ComoPrimerArgumento, ordenarDesc);
+    BuiltinTable::registerFunction("unicos", 1, 1, BuiltinResult::ComoPrimerArgumento, unicos);
+    BuiltinTable::registerFunction("buscar", 2, 2, BuiltinResult::Numero, buscar);
+    BuiltinTable::registerFunction("contiene", 2, 2, BuiltinResult::Numero, contiene);
+    BuiltinTable::registerFunction("claves", 1, 1, BuiltinResult::Texto, claves);
+    
+    BuiltinTable::registerFunction("escalar", 2, 2, BuiltinResult::ListaNumerica, escalar);
+    BuiltinTable::registerFunction("suma", 1, many, BuiltinResult::Numero, suma);
+    BuiltinTable::registerFunction("promedio", 1, many, BuiltinResult::Numero, promedio);
+    BuiltinTable::registerFunction("minimo", 1, many, BuiltinResult::Numero, minimo);
+    BuiltinTable::registerFunction("maximo", 1, many, BuiltinResult::Numero, maximo);
+    
+    BuiltinTable::registerFunction("raiz", 1, 1, BuiltinResult::Numero, raiz);
+    BuiltinTable::registerFunction("potencia", 2, 2, BuiltinResult::Numero, potencia);
+    BuiltinTable::registerFunction("abs", 1, 1, BuiltinResult::Numero, absoluto);
+    BuiltinTable::registerFunction("seno", 1, 1, BuiltinResult::Numero, seno);
+    BuiltinTable::registerFunction("coseno", 1, 1, BuiltinResult::Numero, coseno);
+    BuiltinTable::registerFunction("tangente", 1, 1, BuiltinResult::Numero, tangente);
+    BuiltinTable::registerFunction("logaritmo", 1, 1, BuiltinResult::Numero, logaritmo);
+    BuiltinTable::registerFunction("redondear", 1, 2, BuiltinResult::Numero, redondear);
+    BuiltinTable::registerFunction("piso", 1, 1, BuiltinResult::Numero, piso);
+    BuiltinTable::registerFunction("techo", 1, 1, BuiltinResult::Numero, techo);
+    BuiltinTable::registerFunction("pi", 0, 0, BuiltinResult::Numero, pi);
+}
+
+std::unordered_map<std::string, BuiltinSpec>& BuiltinTable::functions() {
+    static std::unordered_map<std::string, BuiltinSpec> table;
+    return table;
+}
+
+// Igual que la tabla de comandos: las funciones propias se cargan en el primer uso
+void BuiltinTable::loadBuiltins() {
+    static bool loaded = false;
+    if (loaded) return;
+    loaded = true;
+    registerBuiltins();
+}
+
+void BuiltinTable::registerFunction(const std::string& name, size_t minArgs, size_t maxArgs,
+                                    BuiltinResult result, BuiltinCallback callback) {
+    loadBuiltins();
+    functions()[name] = {name, minArgs, std::min(maxArgs, BuiltinArgs::Max), result, callback};
+}
+
+const BuiltinSpec* BuiltinTable::find(const std::string& name) {
+    loadBuiltins();
+    auto it = functions().find(name);
+    return it != functions().end() ? &it->second : nullptr;
+}
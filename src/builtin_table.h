@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include "value.h"
+
+class ExpressionEvaluator;
+
+// Que devuelve la funcion, para decidir sin llamarla si "+" suma o concatena
+enum class BuiltinResult : unsigned char {
+    Numero,
+    Texto,
+    ListaNumerica,
+    ComoPrimerArgumento   // lista del mismo tipo que la recibida (ordenar, unicos)
+};
+
+// Argumentos ya evaluados de una llamada; las variables se pasan sin copiarlas
+struct BuiltinArgs {
+    static constexpr size_t Max = 8;
+    
+    const Value* values[Max];
+    size_t count = 0;
+    
+    const Value& operator[](size_t index) const { return *values[index]; }
+    size_t size() const { return count; }
+};
+
+using BuiltinCallback = Value (*)(ExpressionEvaluator& evaluator, const BuiltinArgs& args);
+
+struct BuiltinSpec {
+    std::string name;
+    size_t minArgs;
+    size_t maxArgs;
+    BuiltinResult result;
+    BuiltinCallback callback;
+};
+
+// Tabla unica de funciones nativas: el analizador de expresiones resuelve el
+// nombre una vez y cada llamada salta directamente a su funcion
+class BuiltinTable {
+private:
+    static std::unordered_map<std::string, BuiltinSpec>& functions();
+    static void loadBuiltins();
+
+public:
+    static void registerFunction(const std::string& name, size_t minArgs, size_t maxArgs,
+                                 BuiltinResult result, BuiltinCallback callback);
+    static const BuiltinSpec* find(const std::string& name);
+};
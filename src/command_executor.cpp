@@ -1,7 +1,7 @@
 #include "command_executor.h"
 #include "utils.h"
+#include "string_table.h"
 #include <iostream>
-#include <limits>
 #include <thread>
 #include <chrono>
 
@@ -9,8 +9,7 @@ CommandExecutor::CommandExecutor() {
     windowManager = new WindowManager();
     bookManager = new BookManager();
     dependencyManager = new DependencyManager();
-    evaluator = new ExpressionEvaluator(intVariables, stringVariables, floatVariables, 
-                                       arrayVariables, windowManager->getWindows());
+    evaluator = new ExpressionEvaluator(symbols, windowManager->getWindows());
 }
 
 CommandExecutor::~CommandExecutor() {
@@ -20,182 +19,132 @@ CommandExecutor::~CommandExecutor() {
     delete evaluator;
 }
 
-std::string CommandExecutor::handleInputFunction(const std::string& funcCall) {
-    if (funcCall.find("pedir_numero(") == 0) {
-        size_t start = funcCall.find('(') + 1;
-        size_t end = funcCall.find_last_of(')');
-        
-        if (start < end) {
-            std::string message = Utils::trim(funcCall.substr(start, end - start));
-            if (!message.empty()) {
-                std::string prompt = evaluator->evaluateStringExpression(message);
-                std::cout << prompt;
-            } else {
-                std::cout << "Ingrese un numero: ";
-            }
-        } else {
-            std::cout << "Ingrese un numero: ";
-        }
-        
-        int num;
-        while (!(std::cin >> num)) {
-            std::cout << "Error: Ingrese un numero valido: ";
-            std::cin.clear();
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        }
-        std::cin.ignore();
-        return std::to_string(num);
-    }
-    
-    if (funcCall.find("pedir_nombre(") == 0) {
-        size_t start = funcCall.find('(') + 1;
-        size_t end = funcCall.find_last_of(')');
-        
-        if (start < end) {
-            std::string message = Utils::trim(funcCall.substr(start, end - start));
-            if (!message.empty()) {
-                std::string prompt = evaluator->evaluateStringExpression(message);
-                std::cout << prompt;
-            } else {
-                std::cout << "Ingrese un texto: ";
-            }
-        } else {
-            std::cout << "Ingrese un texto: ";
-        }
-        
-        std::string nombre;
-        std::getline(std::cin, nombre);
-        return nombre;
-    }
-    return "";
-}
-
-int CommandExecutor::findMatchingListo(const std::vector<std::string>& lines, int startLine) {
-    int depth = 1;
-    for (size_t i = startLine + 1; i < lines.size(); i++) {
-        std::string line = Utils::trim(lines[i]);
-        if (line.find("probar ") == 0 || line.find("receta ") == 0) {
-            depth++;
-        } else if (line == "listo") {
-            depth--;
-            if (depth == 0) {
-                return static_cast<int>(i);
-            }
-        }
+// Arboles de las expresiones del comando: se analizan la primera vez que se evaluan
+const ExprNode* CommandExecutor::exprOf(const Command& cmd) {
+    return evaluator->expression(cmd.expr, cmd.exprTree);
+}
+
+const ExprNode* CommandExecutor::argsOf(const Command& cmd) {
+    return evaluator->expression(cmd.args, cmd.argsTree);
+}
+
+const ExprNode* CommandExecutor::indexOf(const Command& cmd) {
+    return evaluator->expression(cmd.index, cmd.indexTree);
+}
+
+const ExprNode* CommandExecutor::paramOf(const Command& cmd, size_t index) {
+    if (cmd.paramTrees.size() != cmd.params.size()) {
+        cmd.paramTrees.assign(cmd.params.size(), nullptr);
     }
-    return -1;
+    return evaluator->expression(cmd.params[index], cmd.paramTrees[index]);
 }
 
-void CommandExecutor::executeHornear(const std::string& args) {
-    std::string output = evaluator->evaluateStringExpression(args);
+void CommandExecutor::executeHornear(const Command& cmd) {
+    std::string output = evaluator->evaluateStringExpression(argsOf(cmd));
     std::cout << output << std::endl;
 }
 
-void CommandExecutor::executeMostrador(const std::string& args) {
-    std::vector<std::pair<std::string, std::string>> parts = Utils::splitExpression(args);
-    
+void CommandExecutor::executeMostrador(const Command& cmd) {
+    const std::vector<std::string>& params = cmd.params;
     std::string title = "Ventana Pancracio";
     std::string color = "blanco";
     
-    if (parts.size() >= 1) {
-        title = evaluator->evaluateStringExpression(parts[0].first);
+    if (params.size() >= 1) {
+        title = evaluator->evaluateStringExpression(paramOf(cmd, 0));
     }
-    if (parts.size() >= 2) {
-        color = evaluator->evaluateStringExpression(parts[1].first);
+    if (params.size() >= 2) {
+        color = evaluator->evaluateStringExpression(paramOf(cmd, 1));
     }
     
     windowManager->createWindow(title, color);
 }
 
-void CommandExecutor::executeJuego(const std::string& args) {
-    std::vector<std::pair<std::string, std::string>> parts = Utils::splitExpression(args);
-    
+void CommandExecutor::executeJuego(const Command& cmd) {
+    const std::vector<std::string>& params = cmd.params;
     std::string title = "Juego Pancracio";
     
-    if (parts.size() >= 1) {
-        title = evaluator->evaluateStringExpression(parts[0].first);
+    if (params.size() >= 1) {
+        title = evaluator->evaluateStringExpression(paramOf(cmd, 0));
     }
     
     windowManager->createWindow(title, "negro", true);
     
+    int titleId = StringTable::intern(title);
     for (auto& win : windowManager->getWindows()) {
-        if (win.title == title && win.isGameWindow) {
+        if (win.titleId == titleId && win.isGameWindow) {
             win.gameRunning = true;
             break;
         }
     }
 }
 
-void CommandExecutor::executeObjeto(const std::string& args) {
-    std::vector<std::pair<std::string, std::string>> parts = Utils::splitExpression(args);
-    
-    if (parts.size() < 6) {
+void CommandExecutor::executeObjeto(const Command& cmd) {
+    const std::vector<std::string>& params = cmd.params;
+    if (params.size() < 6) {
         std::cerr << "Error: objeto necesita al menos 6 parametros" << std::endl;
         return;
     }
     
-    std::string windowTitle = evaluator->evaluateStringExpression(parts[0].first);
-    std::string objName = evaluator->evaluateStringExpression(parts[1].first);
-    int x = evaluator->evaluateIntExpression(parts[2].first);
-    int y = evaluator->evaluateIntExpression(parts[3].first);
-    int width = evaluator->evaluateIntExpression(parts[4].first);
-    int height = evaluator->evaluateIntExpression(parts[5].first);
-    std::string color = parts.size() >= 7 ? evaluator->evaluateStringExpression(parts[6].first) : "blanco";
+    int windowId = evaluator->evaluateSymbol(paramOf(cmd, 0));
+    int objId = evaluator->evaluateSymbol(paramOf(cmd, 1));
+    int x = evaluator->evaluateIntExpression(paramOf(cmd, 2));
+    int y = evaluator->evaluateIntExpression(paramOf(cmd, 3));
+    int width = evaluator->evaluateIntExpression(paramOf(cmd, 4));
+    int height = evaluator->evaluateIntExpression(paramOf(cmd, 5));
+    std::string color = params.size() >= 7 ? evaluator->evaluateStringExpression(paramOf(cmd, 6)) : "blanco";
     
     for (auto& win : windowManager->getWindows()) {
-        if (win.title == windowTitle && win.isGameWindow) {
+        if (win.titleId == windowId && win.isGameWindow) {
             GameObject obj;
             obj.x = x; obj.y = y; obj.width = width; obj.height = height;
             obj.vx = 0; obj.vy = 0; obj.color = color; obj.visible = true;
-            win.gameObjects[objName] = obj;
+            win.gameObjects[objId] = obj;
             InvalidateRect(win.hwnd, NULL, FALSE);
             return;
         }
     }
-    std::cerr << "Error: Ventana de juego '" << windowTitle << "' no encontrada" << std::endl;
+    std::cerr << "Error: Ventana de juego '" << StringTable::text(windowId) << "' no encontrada" << std::endl;
 }
 
-void CommandExecutor::executeMover(const std::string& args) {
-    std::vector<std::pair<std::string, std::string>> parts = Utils::splitExpression(args);
-    
-    if (parts.size() < 4) {
+void CommandExecutor::executeMover(const Command& cmd) {
+    const std::vector<std::string>& params = cmd.params;
+    if (params.size() < 4) {
         std::cerr << "Error: mover necesita al menos 4 parametros" << std::endl;
         return;
     }
     
-    std::string windowTitle = evaluator->evaluateStringExpression(parts[0].first);
-    std::string objName = evaluator->evaluateStringExpression(parts[1].first);
-    int vx = evaluator->evaluateIntExpression(parts[2].first);
-    int vy = evaluator->evaluateIntExpression(parts[3].first);
+    int windowId = evaluator->evaluateSymbol(paramOf(cmd, 0));
+    int objId = evaluator->evaluateSymbol(paramOf(cmd, 1));
+    int vx = evaluator->evaluateIntExpression(paramOf(cmd, 2));
+    int vy = evaluator->evaluateIntExpression(paramOf(cmd, 3));
     
     for (auto& win : windowManager->getWindows()) {
-        if (win.title == windowTitle && win.isGameWindow) {
-            auto it = win.gameObjects.find(objName);
+        if (win.titleId == windowId && win.isGameWindow) {
+            auto it = win.gameObjects.find(objId);
             if (it != win.gameObjects.end()) {
                 it->second.vx = vx; it->second.vy = vy;
                 return;
             }
         }
     }
-    std::cerr << "Error: Objeto '" << objName << "' no encontrado" << std::endl;
+    std::cerr << "Error: Objeto '" << StringTable::text(objId) << "' no encontrado" << std::endl;
 }
 
-void CommandExecutor::executeColision(const std::string& args, bool& result) {
-    std::vector<std::pair<std::string, std::string>> parts = Utils::splitExpression(args);
-    
-    if (parts.size() < 3) {
+void CommandExecutor::executeColision(const Command& cmd, bool& result) {
+    const std::vector<std::string>& params = cmd.params;
+    if (params.size() < 3) {
         result = false;
         return;
     }
     
-    std::string windowTitle = evaluator->evaluateStringExpression(parts[0].first);
-    std::string obj1Name = evaluator->evaluateStringExpression(parts[1].first);
-    std::string obj2Name = evaluator->evaluateStringExpression(parts[2].first);
+    int windowId = evaluator->evaluateSymbol(paramOf(cmd, 0));
+    int obj1Id = evaluator->evaluateSymbol(paramOf(cmd, 1));
+    int obj2Id = evaluator->evaluateSymbol(paramOf(cmd, 2));
     
     for (auto& win : windowManager->getWindows()) {
-        if (win.title == windowTitle && win.isGameWindow) {
-            auto it1 = win.gameObjects.find(obj1Name);
-            auto it2 = win.gameObjects.find(obj2Name);
+        if (win.titleId == windowId && win.isGameWindow) {
+            auto it1 = win.gameObjects.find(obj1Id);
+            auto it2 = win.gameObjects.find(obj2Id);
             
             if (it1 != win.gameObjects.end() && it2 != win.gameObjects.end()) {
                 GameObject& obj1 = it1->second;
@@ -214,20 +163,19 @@ void CommandExecutor::executeColision(const std::string& args, bool& result) {
     result = false;
 }
 
-void CommandExecutor::executeOcultar(const std::string& args) {
-    std::vector<std::pair<std::string, std::string>> parts = Utils::splitExpression(args);
-    
-    if (parts.size() < 2) {
+void CommandExecutor::executeOcultar(const Command& cmd) {
+    const std::vector<std::string>& params = cmd.params;
+    if (params.size() < 2) {
         std::cerr << "Error: ocultar necesita 2 parametros" << std::endl;
         return;
     }
     
-    std::string windowTitle = evaluator->evaluateStringExpression(parts[0].first);
-    std::string objName = evaluator->evaluateStringExpression(parts[1].first);
+    int windowId = evaluator->evaluateSymbol(paramOf(cmd, 0));
+    int objId = evaluator->evaluateSymbol(paramOf(cmd, 1));
     
     for (auto& win : windowManager->getWindows()) {
-        if (win.title == windowTitle && win.isGameWindow) {
-            auto it = win.gameObjects.find(objName);
+        if (win.titleId == windowId && win.isGameWindow) {
+            auto it = win.gameObjects.find(objId);
             if (it != win.gameObjects.end()) {
                 it->second.visible = false;
                 InvalidateRect(win.hwnd, NULL, FALSE);
@@ -235,25 +183,24 @@ void CommandExecutor::executeOcultar(const std::string& args) {
             }
         }
     }
-    std::cerr << "Error: Objeto '" << objName << "' no encontrado" << std::endl;
+    std::cerr << "Error: Objeto '" << StringTable::text(objId) << "' no encontrado" << std::endl;
 }
 
-void CommandExecutor::executePosicionar(const std::string& args) {
-    std::vector<std::pair<std::string, std::string>> parts = Utils::splitExpression(args);
-    
-    if (parts.size() < 4) {
+void CommandExecutor::executePosicionar(const Command& cmd) {
+    const std::vector<std::string>& params = cmd.params;
+    if (params.size() < 4) {
         std::cerr << "Error: posicionar necesita 4 parametros" << std::endl;
         return;
     }
     
-    std::string windowTitle = evaluator->evaluateStringExpression(parts[0].first);
-    std::string objName = evaluator->evaluateStringExpression(parts[1].first);
-    int x = evaluator->evaluateIntExpression(parts[2].first);
-    int y = evaluator->evaluateIntExpression(parts[3].first);
+    int windowId = evaluator->evaluateSymbol(paramOf(cmd, 0));
+    int objId = evaluator->evaluateSymbol(paramOf(cmd, 1));
+    int x = evaluator->evaluateIntExpression(paramOf(cmd, 2));
+    int y = evaluator->evaluateIntExpression(paramOf(cmd, 3));
     
     for (auto& win : windowManager->getWindows()) {
-        if (win.title == windowTitle && win.isGameWindow) {
-            auto it = win.gameObjects.find(objName);
+        if (win.titleId == windowId && win.isGameWindow) {
+            auto it = win.gameObjects.find(objId);
             if (it != win.gameObjects.end()) {
                 it->second.x = x; it->second.y = y;
                 return;
@@ -262,69 +209,66 @@ void CommandExecutor::executePosicionar(const std::string& args) {
     }
 }
 
-void CommandExecutor::executeEscribir(const std::string& args) {
-    std::vector<std::pair<std::string, std::string>> parts = Utils::splitExpression(args);
-    
-    if (parts.size() < 2) {
+void CommandExecutor::executeEscribir(const Command& cmd) {
+    const std::vector<std::string>& params = cmd.params;
+    if (params.size() < 2) {
         std::cerr << "Error: escribir necesita al menos 2 parametros" << std::endl;
         return;
     }
     
-    std::string windowTitle = evaluator->evaluateStringExpression(parts[0].first);
-    std::string text = evaluator->evaluateStringExpression(parts[1].first);
+    std::string windowTitle = evaluator->evaluateStringExpression(paramOf(cmd, 0));
+    std::string text = evaluator->evaluateStringExpression(paramOf(cmd, 1));
     
     windowManager->writeToWindow(windowTitle, text);
 }
 
-void CommandExecutor::executeLibro(const std::string& args) {
-    std::vector<std::pair<std::string, std::string>> parts = Utils::splitExpression(args);
-    
-    if (parts.empty()) {
+void CommandExecutor::executeLibro(const Command& cmd) {
+    const std::vector<std::string>& params = cmd.params;
+    if (params.empty()) {
         std::cerr << "Error: libro necesita al menos 1 parametro" << std::endl;
         return;
     }
     
-    std::string action = evaluator->evaluateStringExpression(parts[0].first);
+    std::string action = evaluator->evaluateStringExpression(paramOf(cmd, 0));
     
     if (action == "crear") {
-        if (parts.size() < 2) {
+        if (params.size() < 2) {
             std::cerr << "Error: libro \"crear\" necesita el nombre del archivo" << std::endl;
             return;
         }
-        std::string filename = evaluator->evaluateStringExpression(parts[1].first);
+        std::string filename = evaluator->evaluateStringExpression(paramOf(cmd, 1));
         bookManager->createFile(filename);
         
     } else if (action == "abrir") {
-        if (parts.size() < 2) {
+        if (params.size() < 2) {
             std::cerr << "Error: libro \"abrir\" necesita el nombre del archivo" << std::endl;
             return;
         }
-        std::string filename = evaluator->evaluateStringExpression(parts[1].first);
+        std::string filename = evaluator->evaluateStringExpression(paramOf(cmd, 1));
         bookManager->openFile(filename);
         
     } else if (action == "guardar") {
-        if (parts.size() >= 2) {
-            std::string filename = evaluator->evaluateStringExpression(parts[1].first);
+        if (params.size() >= 2) {
+            std::string filename = evaluator->evaluateStringExpression(paramOf(cmd, 1));
             bookManager->saveFile(filename);
         } else {
             bookManager->saveFile();
         }
         
     } else if (action == "escribir") {
-        if (parts.size() < 3) {
+        if (params.size() < 3) {
             std::cerr << "Error: libro \"escribir\" necesita clave y valor" << std::endl;
             return;
         }
-        std::string key = evaluator->evaluateStringExpression(parts[1].first);
-        std::string value = evaluator->evaluateStringExpression(parts[2].first);
-        bookManager->writeData(key, value);
+        std::string key = evaluator->evaluateStringExpression(paramOf(cmd, 1));
+        bookManager->writeData(key, evaluator->evaluateTyped(paramOf(cmd, 2)));
         
     } else if (action == "leer") {
-        if (parts.size() < 2) {
+        if (params.size() < 2) {
             std::cerr << "Error: libro \"leer\" necesita la clave" << std::endl;
             return;
         }
-        std::string key = evaluator->evaluateStringExpression(parts[1].first);
+        std::string key = evaluator->evaluateStringExpression(paramOf(cmd, 1));
         std::string result = bookManager->readData(key);
         if (!result.empty()) {
             std::cout << result << std::endl;
@@ -333,80 +277,56 @@ void CommandExecutor::executeLibro(const std::string& args) {
         }
         
     } else if (action == "obtener") {
-        if (parts.size() < 3) {
+        if (params.size() < 3) {
             std::cerr << "Error: libro \"obtener\" necesita clave y variable destino" << std::endl;
             return;
         }
-        std::string key = evaluator->evaluateStringExpression(parts[1].first);
-        std::string varName = evaluator->evaluateStringExpression(parts[2].first);
+        std::string key = evaluator->evaluateStringExpression(paramOf(cmd, 1));
+        std::string varName = evaluator->evaluateStringExpression(paramOf(cmd, 2));
         
         if (!Utils::isValidVariableName(varName)) {
             std::cerr << "Error: '" << varName << "' no es un nombre de variable valido" << std::endl;
             return;
         }
         
-        std::string value = bookManager->readData(key);
-        if (!value.empty()) {
-            if (value.length() >= 2 && value.front() == '[' && value.back() == ']') {
-                std::vector<std::string> listItems = Utils::parseArray(value);
-                arrayVariables[varName] = listItems;
-                
-                std::string displayValue = "";
-                for (size_t i = 0; i < listItems.size(); i++) {
-                    if (i > 0) displayValue += ", ";
-                    displayValue += listItems[i];
-                }
-                stringVariables[varName] = displayValue;
-                
-            } else if (value.find('.') != std::string::npos) {
-                try {
-                    double floatVal = std::stod(value);
-                    floatVariables[varName] = floatVal;
-                } catch (...) {
-                    stringVariables[varName] = value;
-                }
-            } else {
-                try {
-                    int intVal = std::stoi(value);
-                    intVariables[varName] = intVal;
-                } catch (...) {
-                    stringVariables[varName] = value;
-                }
-            }
+        // El valor llega con el tipo que tiene en el libro
+        Value value;
+        if (bookManager->readValue(key, value)) {
+            symbols.assign(symbols.resolve(varName), std::move(value));
         }
         
     } else if (action == "existe") {
         // Se maneja en executeConditional
         
     } else if (action == "borrar") {
-        if (parts.size() < 2) {
+        if (params.size() < 2) {
             std::cerr << "Error: libro \"borrar\" necesita la clave" << std::endl;
             return;
         }
-        std::string key = evaluator->evaluateStringExpression(parts[1].first);
+        std::string key = evaluator->evaluateStringExpression(paramOf(cmd, 1));
         bookManager->deleteKey(key);
         
     } else if (action == "agregar") {
-        if (parts.size() < 3) {
+        if (params.size() < 3) {
             std::cerr << "Error: libro \"agregar\" necesita clave de lista y valor" << std::endl;
             return;
         }
-        std::string key = evaluator->evaluateStringExpression(parts[1].first);
-        std::string value = evaluator->evaluateStringExpression(parts[2].first);
+        std::string key = evaluator->evaluateStringExpression(paramOf(cmd, 1));
+        std::string value = evaluator->evaluateStringExpression(paramOf(cmd, 2));
         bookManager->addToList(key, value);
         
     } else if (action == "quitar") {
-        if (parts.size() < 3) {
+        if (params.size() < 3) {
             std::cerr << "Error: libro \"quitar\" necesita clave de lista y valor/indice" << std::endl;
             return;
         }
-        std::string key = evaluator->evaluateStringExpression(parts[1].first);
-        std::string valueOrIndex = evaluator->evaluateStringExpression(parts[2].first);
+        std::string key = evaluator->evaluateStringExpression(paramOf(cmd, 1));
+        std::string valueOrIndex = evaluator->evaluateStringExpression(paramOf(cmd, 2));
         
-        try {
-            int index = std::stoi(valueOrIndex);
-            bookManager->removeFromListByIndex(key, index);
-        } catch (...) {
+        long long index;
+        if (Utils::parseInteger(valueOrIndex, index)) {
+            bookManager->removeFromListByIndex(key, static_cast<int>(index));
+        } else {
             bookManager->removeFromList(key, valueOrIndex);
         }
         
@@ -423,7 +343,7 @@ void CommandExecutor::executeLibro(const std::string& args) {
 
 void CommandExecutor::executeReceta(const std::string& args) {
     // Comando para importar dependencias
-    std::string depName = Utils::trim(args);
+    std::string depName(Utils::trim(args));
     
     // Remover comillas si las tiene
     if (depName.length() >= 2 && depName.front() == '"' && depName.back() == '"') {
@@ -450,28 +370,27 @@ void CommandExecutor::executeReceta(const std::string& args) {
     }
 }
 
-void CommandExecutor::executeDiscord(const std::string& args) {
+void CommandExecutor::executeDiscord(const Command& cmd) {
+    const std::vector<std::string>& params = cmd.params;
     if (!dependencyManager->isDependencyLoaded("la_receta_de_discord")) {
         std::cerr << "Error: Primero debe cargar la dependencia Discord con: receta \"la_receta_de_discord\"" << std::endl;
         return;
     }
     
-    std::vector<std::pair<std::string, std::string>> parts = Utils::splitExpression(args);
-    
-    if (parts.empty()) {
+    if (params.empty()) {
         std::cerr << "Error: discord necesita al menos 1 parámetro" << std::endl;
         return;
     }
     
-    std::string action = evaluator->evaluateStringExpression(parts[0].first);
+    std::string action = evaluator->evaluateStringExpression(paramOf(cmd, 0));
     
     if (action == "conectar") {
-        if (parts.size() < 3) {
+        if (params.size() < 3) {
             std::cerr << "Error: discord \"conectar\" necesita token y bot_id" << std::endl;
             return;
         }
-        std::string token = evaluator->evaluateStringExpression(parts[1].first);
-        std::string botId = evaluator->evaluateStringExpression(parts[2].first);
+        std::string token = evaluator->evaluateStringExpression(paramOf(cmd, 1));
+        std::string botId = evaluator->evaluateStringExpression(paramOf(cmd, 2));
         
         if (dependencyManager->initializeDiscord(token, botId)) {
             std::cout << "🎯 Conexión establecida con Discord API" << std::endl;
@@ -484,12 +403,12 @@ void CommandExecutor::executeDiscord(const std::string& args) {
         }
         
     } else if (action == "enviar") {
-        if (parts.size() < 3) {
+        if (params.size() < 3) {
             std::cerr << "Error: discord \"enviar\" necesita canal_id y mensaje" << std::endl;
             return;
         }
-        std::string channelId = evaluator->evaluateStringExpression(parts[1].first);
-        std::string message = evaluator->evaluateStringExpression(parts[2].first);
+        std::string channelId = evaluator->evaluateStringExpression(paramOf(cmd, 1));
+        std::string message = evaluator->evaluateStringExpression(paramOf(cmd, 2));
         
         if (!dependencyManager->sendMessage(channelId, message)) {
             std::cerr << "💡 Posibles causas:" << std::endl;
@@ -499,54 +418,54 @@ void CommandExecutor::executeDiscord(const std::string& args) {
         }
         
     } else if (action == "estado") {
-        if (parts.size() < 3) {
+        if (params.size() < 3) {
             std::cerr << "Error: discord \"estado\" necesita status y actividad" << std::endl;
             return;
         }
-        std::string status = evaluator->evaluateStringExpression(parts[1].first);
-        std::string activity = evaluator->evaluateStringExpression(parts[2].first);
+        std::string status = evaluator->evaluateStringExpression(paramOf(cmd, 1));
+        std::string activity = evaluator->evaluateStringExpression(paramOf(cmd, 2));
         dependencyManager->setStatus(status, activity);
         
     } else if (action == "registrar_slash") {
-        if (parts.size() < 3) {
+        if (params.size() < 3) {
             std::cerr << "Error: discord \"registrar_slash\" necesita comando y descripción" << std::endl;
             return;
         }
-        std::string command = evaluator->evaluateStringExpression(parts[1].first);
-        std::string description = evaluator->evaluateStringExpression(parts[2].first);
+        std::string command = evaluator->evaluateStringExpression(paramOf(cmd, 1));
+        std::string description = evaluator->evaluateStringExpression(paramOf(cmd, 2));
         dependencyManager->registerSlashCommand(command, description);
         
     } else if (action == "configurar_prefijo") {
-        if (parts.size() < 2) {
+        if (params.size() < 2) {
             std::cerr << "Error: discord \"configurar_prefijo\" necesita el prefijo" << std::endl;
             return;
         }
-        std::string prefix = evaluator->evaluateStringExpression(parts[1].first);
+        std::string prefix = evaluator->evaluateStringExpression(paramOf(cmd, 1));
         dependencyManager->setCommandPrefix(prefix);
         
     } else if (action == "registrar_manejador") {
-        if (parts.size() < 3) {
+        if (params.size() < 3) {
             std::cerr << "Error: discord \"registrar_manejador\" necesita tipo y función" << std::endl;
             return;
         }
-        std::string type = evaluator->evaluateStringExpression(parts[1].first);
-        std::string function = evaluator->evaluateStringExpression(parts[2].first);
+        std::string type = evaluator->evaluateStringExpression(paramOf(cmd, 1));
+        std::string function = evaluator->evaluateStringExpression(paramOf(cmd, 2));
         dependencyManager->registerCommandHandler(type, function);
         
     } else if (action == "iniciar_bot_real") {
-        if (parts.size() < 2) {
+        if (params.size() < 2) {
             std::cerr << "Error: discord \"iniciar_bot_real\" necesita canal_id" << std::endl;
             return;
         }
-        std::string channelId = evaluator->evaluateStringExpression(parts[1].first);
+        std::string channelId = evaluator->evaluateStringExpression(paramOf(cmd, 1));
         dependencyManager->startRealBot(channelId);
         
     } else if (action == "canal") {
-        if (parts.size() < 2) {
+        if (params.size() < 2) {
             std::cerr << "Error: discord \"canal\" necesita canal_id" << std::endl;
             return;
         }
-        std::string channelId = evaluator->evaluateStringExpression(parts[1].first);
+        std::string channelId = evaluator->evaluateStringExpression(paramOf(cmd, 1));
         std::string channelName = dependencyManager->getChannelInfo(channelId);
         if (!channelName.empty()) {
             std::cout << "📺 Canal: #" << channelName << " (ID: " << channelId << ")" << std::endl;
@@ -555,10 +474,10 @@ void CommandExecutor::executeDiscord(const std::string& args) {
         }
         
     } else if (action == "conectado") {
-        if (parts.size() >= 2) {
-            std::string varName = evaluator->evaluateStringExpression(parts[1].first);
+        if (params.size() >= 2) {
+            std::string varName = evaluator->evaluateStringExpression(paramOf(cmd, 1));
             if (Utils::isValidVariableName(varName)) {
-                intVariables[varName] = dependencyManager->isConnected() ? 1 : 0;
+                symbols.assign(symbols.resolve(varName), Value::fromInt(dependencyManager->isConnected() ? 1 : 0));
             }
         } else {
             std::cout << (dependencyManager->isConnected() ? "true" : "false") << std::endl;
@@ -596,255 +515,269 @@ void CommandExecutor::executeDiscord(const std::string& args) {
     }
 }
 
-void CommandExecutor::executeIngrediente(const std::string& args) {
-    size_t equalPos = args.find(" = ");
-    if (equalPos == std::string::npos) {
+void CommandExecutor::executeQuitar(const Command& cmd) {
+    if (cmd.slot == -1 || cmd.index.empty()) {
+        std::cerr << "Error: Sintaxis incorrecta en quitar (se espera quitar lista[indice])" << std::endl;
+        return;
+    }
+    evaluator->removeItem(cmd.slot, indexOf(cmd));
+}
+
+// semilla n: desde aqui los numeros aleatorios se repiten en cada ejecucion
+void CommandExecutor::executeSemilla(const Command& cmd) {
+    evaluator->randomGenerator().seed(static_cast<uint64_t>(evaluator->evaluateIntExpression(argsOf(cmd))));
+}
+
+void CommandExecutor::executeIngrediente(const Command& cmd) {
+    if (cmd.name.empty()) {
         std::cerr << "Error: Sintaxis incorrecta en declaracion de ingrediente" << std::endl;
         return;
     }
     
-    std::string varName = Utils::trim(args.substr(0, equalPos));
-    std::string value = Utils::trim(args.substr(equalPos + 3));
+    const std::string& varName = cmd.name;
     
     if (!Utils::isValidVariableName(varName)) {
         std::cerr << "Error: '" << varName << "' no es un nombre de variable valido" << std::endl;
         return;
     }
     
-    if (value.find("pedir_numero(") == 0 || value == "pedir_numero()") {
-        std::string result = handleInputFunction(value);
-        try {
-            intVariables[varName] = std::stoi(result);
-        } catch (...) {
-            intVariables[varName] = 0;
-        }
-    } else if (value.find("pedir_nombre(") == 0 || value == "pedir_nombre()") {
-        std::string result = handleInputFunction(value);
-        stringVariables[varName] = result;
-    } else if (Utils::isArrayExpression(value, arrayVariables)) {
-        if (value.length() >= 2 && value.front() == '[' && value.back() == ']') {
-            arrayVariables[varName] = Utils::parseArray(value);
-        } else {
-            arrayVariables[varName] = arrayVariables[value];
-        }
-    } else if (Utils::isStringExpression(value, stringVariables) || 
-               (value.length() >= 2 && value.front() == '"' && value.back() == '"')) {
-        stringVariables[varName] = evaluator->evaluateStringExpression(value);
-    } else if (Utils::isFloatExpression(value, floatVariables)) {
-        floatVariables[varName] = evaluator->evaluateFloatExpression(value);
-    } else {
-        try {
-            intVariables[varName] = evaluator->evaluateIntExpression(value);
-        } catch (...) {
-            stringVariables[varName] = evaluator->evaluateStringExpression(value);
-        }
+    const ExprNode* value = exprOf(cmd);
+    if (!cmd.index.empty()) {
+        evaluator->assignItem(cmd.slot, indexOf(cmd), value);
+    } else if (!evaluator->appendInPlace(cmd.slot, value)) {
+        symbols.assign(cmd.slot, evaluator->evaluate(value));
     }
 }
 
-void CommandExecutor::executeRecetaDefinition(const std::vector<std::string>& lines, int& currentLine) {
-    std::string line = Utils::trim(lines[currentLine]);
+void CommandExecutor::executeRecetaDefinition(const std::vector<Command>& code, int& currentLine, int endLine) {
+    const Command& cmd = code[currentLine];
+    int bodyEnd = cmd.blockEnd == -1 ? endLine : cmd.blockEnd;
     
-    size_t nameStart = line.find("receta ") + 7;
-    size_t parenPos = line.find('(');
-    size_t parenEnd = line.find(')');
-    
-    if (parenPos == std::string::npos || parenEnd == std::string::npos) {
+    if (cmd.name.empty()) {
         std::cerr << "Error: Sintaxis incorrecta en receta" << std::endl;
+        currentLine = bodyEnd;
         return;
     }
     
-    std::string funcName = Utils::trim(line.substr(nameStart, parenPos - nameStart));
-    std::string paramStr = Utils::trim(line.substr(parenPos + 1, parenEnd - parenPos - 1));
-    
-    if (!Utils::isValidVariableName(funcName)) {
-        std::cerr << "Error: Nombre de receta invalido: " << funcName << std::endl;
+    if (!Utils::isValidVariableName(cmd.name)) {
+        std::cerr << "Error: Nombre de receta invalido: " << cmd.name << std::endl;
+        currentLine = bodyEnd;
         return;
     }
     
     Function func;
-    func.parameters = Utils::parseParameters(paramStr);
-    func.startLine = currentLine;
+    func.parameters = cmd.params;
+    func.parameterSlots = cmd.paramSlots;
+    func.code = program;
+    func.bodyStart = currentLine + 1;
+    func.bodyEnd = bodyEnd;
+    func.startLine = cmd.line;
+    
+    functions[cmd.symbol] = func;
+    currentLine = bodyEnd;
+}
+
+bool CommandExecutor::enterReceta(const Command& cmd, Function& func) {
+    if (cmd.name.empty()) {
+        std::cerr << "Error: Sintaxis incorrecta en cocinar" << std::endl;
+        return false;
+    }
     
-    currentLine++;
-    while (currentLine < static_cast<int>(lines.size())) {
-        std::string bodyLine = Utils::trim(lines[currentLine]);
-        if (bodyLine == "listo") break;
-        func.body.push_back(lines[currentLine]);
-        currentLine++;
+    auto funcIt = functions.find(cmd.symbol);
+    if (funcIt == functions.end()) {
+        std::cerr << "Error: Receta no encontrada: " << cmd.name << std::endl;
+        return false;
     }
     
-    functions[funcName] = func;
+    // Copia: la receta puede redefinirse a si misma mientras se ejecuta
+    func = funcIt->second;
+    symbols.pushFrame();
+    
+    try {
+        for (size_t i = 0; i < func.parameterSlots.size() && i < cmd.params.size(); i++) {
+            symbols.assign(func.parameterSlots[i], evaluator->evaluate(paramOf(cmd, i)));
+        }
+    } catch (...) {
+        leaveReceta();
+        throw;
+    }
+    return true;
 }
 
-void CommandExecutor::executeCocinar(const std::string& args) {
-    size_t parenPos = args.find('(');
-    size_t parenEnd = args.find(')');
+void CommandExecutor::leaveReceta() {
+    symbols.popFrame();
+}
+
+void CommandExecutor::executeCocinar(const Command& cmd) {
+    Function func;
+    if (!enterReceta(cmd, func)) return;
     
-    if (parenPos == std::string::npos || parenEnd == std::string::npos) {
-        std::cerr << "Error: Sintaxis incorrecta en cocinar" << std::endl;
-        return;
+    executeRange(*func.code, func.bodyStart, func.bodyEnd);
+    leaveReceta();
+}
+
+bool CommandExecutor::evaluateBranchCondition(const Command& cmd) {
+    const std::string& condition = cmd.expr;
+    
+    if (condition.find("libro \"existe\"") != std::string::npos) {
+        size_t start = condition.find("\"existe\", \"") + 11;
+        size_t end = condition.find("\"", start);
+        if (end != std::string::npos) {
+            std::string key = condition.substr(start, end - start);
+            return bookManager->existsKey(key);
+        }
+        return false;
     }
     
-    std::string funcName = Utils::trim(args.substr(0, parenPos));
-    std::string argsStr = Utils::trim(args.substr(parenPos + 1, parenEnd - parenPos - 1));
+    return evaluator->evaluateCondition(exprOf(cmd));
+}
+
+// Una condicion que falla cuenta como falsa, igual que en la maquina virtual
+bool CommandExecutor::conditionHolds(const Command& cmd) {
+    try {
+        return evaluateBranchCondition(cmd);
+    } catch (const std::exception& e) {
+        std::cerr << "Error en la linea " << cmd.line << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+void CommandExecutor::executeConditional(const std::vector<Command>& code, int& currentLine, int endLine) {
+    int listoLine = code[currentLine].blockEnd;
     
-    if (functions.find(funcName) == functions.end()) {
-        std::cerr << "Error: Receta no encontrada: " << funcName << std::endl;
+    if (listoLine == -1) {
+        std::cerr << "Error: No se encontro 'listo' para cerrar el condicional" << std::endl;
         return;
     }
     
-    Function& func = functions[funcName];
-    std::vector<std::string> callArgs = Utils::parseParameters(argsStr);
-    
-    auto savedIntVars = intVariables;
-    auto savedStringVars = stringVariables;
-    auto savedFloatVars = floatVariables;
-    auto savedArrayVars = arrayVariables;
-    
-    for (size_t i = 0; i < func.parameters.size() && i < callArgs.size(); i++) {
-        std::string paramName = func.parameters[i];
-        std::string argValue = callArgs[i];
+    // Recorrer las ramas probar / sino / alternativa con los saltos ya resueltos
+    int branchLine = currentLine;
+    while (branchLine < listoLine) {
+        const Command& branch = code[branchLine];
         
-        if (Utils::isStringExpression(argValue, stringVariables) || 
-            (argValue.length() >= 2 && argValue.front() == '"' && argValue.back() == '"')) {
-            stringVariables[paramName] = evaluator->evaluateStringExpression(argValue);
-        } else if (Utils::isFloatExpression(argValue, floatVariables)) {
-            floatVariables[paramName] = evaluator->evaluateFloatExpression(argValue);
-        } else {
-            intVariables[paramName] = evaluator->evaluateIntExpression(argValue);
+        if (branch.type == CommandType::Alternativa || conditionHolds(branch)) {
+            executeRange(code, branchLine + 1, branch.nextBranch);
+            break;
         }
+        branchLine = branch.nextBranch;
     }
     
-    for (int i = 0; i < static_cast<int>(func.body.size()); i++) {
-        executeLine(func.body, i);
+    currentLine = listoLine;
+}
+
+long long CommandExecutor::evaluateRepeatCount(const Command& cmd) {
+    return evaluator->evaluateIntExpression(exprOf(cmd));
+}
+
+Value CommandExecutor::evaluateForEachList(const Command& cmd) {
+    if (cmd.slot == -1) {
+        std::cerr << "Error: '" << cmd.name << "' no es un nombre de variable valido" << std::endl;
+        return Value::fromList({});
     }
     
-    intVariables = savedIntVars;
-    stringVariables = savedStringVars;
-    floatVariables = savedFloatVars;
-    arrayVariables = savedArrayVars;
+    Value list = evaluator->evaluate(exprOf(cmd));
+    if (list.getType() == ValueType::Diccionario) {
+        return ExpressionEvaluator::keysOf(list);
+    }
+    if (list.getType() != ValueType::Lista) {
+        std::cerr << "Error: '" << cmd.expr << "' no es una lista" << std::endl;
+        return Value::fromList({});
+    }
+    return list;
 }
 
-void CommandExecutor::executeConditional(const std::vector<std::string>& lines, int& currentLine) {
-    std::string line = Utils::trim(lines[currentLine]);
-    int listoLine = findMatchingListo(lines, currentLine);
+void CommandExecutor::assignLoopVariable(const Command& cmd, const Value& list, size_t index) {
+    symbols.assign(cmd.slot, list.listItem(index));
+}
+
+void CommandExecutor::executeLoop(const std::vector<Command>& code, int& currentLine, int endLine) {
+    const Command& cmd = code[currentLine];
+    int listoLine = cmd.blockEnd;
     
     if (listoLine == -1) {
-        std::cerr << "Error: No se encontro 'listo' para cerrar el condicional" << std::endl;
+        std::cerr << "Error: No se encontro 'listo' para cerrar el bucle" << std::endl;
         return;
     }
     
-    bool conditionMet = false;
-    
-    if (line.find("probar ") == 0 && line.back() == ':') {
-        std::string condition = line.substr(7);
-        condition = condition.substr(0, condition.length() - 1);
-        
-        if (condition.find("libro \"existe\"") != std::string::npos) {
-            size_t start = condition.find("\"existe\", \"") + 11;
-            size_t end = condition.find("\"", start);
-            if (end != std::string::npos) {
-                std::string key = condition.substr(start, end - start);
-                conditionMet = bookManager->existsKey(key);
+    int bodyStart = currentLine + 1;
+    switch (cmd.type) {
+        case CommandType::Repetir: {
+            long long times = evaluateRepeatCount(cmd);
+            for (long long i = 0; i < times; i++) {
+                executeRange(code, bodyStart, listoLine);
             }
-        } else {
-            conditionMet = evaluator->evaluateCondition(condition);
+            break;
         }
-        
-        if (conditionMet) {
-            currentLine++;
-            while (currentLine < listoLine) {
-                std::string innerLine = Utils::trim(lines[currentLine]);
-                if (innerLine.find("sino ") == 0 || innerLine == "alternativa:") {
-                    break;
-                }
-                executeLine(lines, currentLine);
-                currentLine++;
+        case CommandType::Mientras:
+            while (conditionHolds(cmd)) {
+                executeRange(code, bodyStart, listoLine);
             }
-        }
-    }
-    
-    if (!conditionMet) {
-        currentLine++;
-        while (currentLine < listoLine) {
-            std::string innerLine = Utils::trim(lines[currentLine]);
-            
-            if (innerLine.find("sino ") == 0 && innerLine.back() == ':') {
-                std::string condition = innerLine.substr(5);
-                condition = condition.substr(0, condition.length() - 1);
-                
-                if (evaluator->evaluateCondition(condition)) {
-                    conditionMet = true;
-                    currentLine++;
-                    while (currentLine < listoLine) {
-                        std::string nextLine = Utils::trim(lines[currentLine]);
-                        if (nextLine.find("sino ") == 0 || nextLine == "alternativa:") {
-                            break;
-                        }
-                        executeLine(lines, currentLine);
-                        currentLine++;
-                    }
-                    break;
-                }
-            } else if (innerLine == "alternativa:") {
-                if (!conditionMet) {
-                    currentLine++;
-                    while (currentLine < listoLine) {
-                        executeLine(lines, currentLine);
-                        currentLine++;
-                    }
-                }
-                break;
+            break;
+        case CommandType::ParaCada: {
+            Value list = evaluateForEachList(cmd);
+            for (size_t i = 0; i < list.listSize(); i++) {
+                assignLoopVariable(cmd, list, i);
+                executeRange(code, bodyStart, listoLine);
             }
-            currentLine++;
+            break;
         }
-        std::cerr << "Acciones disponibles: conectar, enviar, estado, canal, conectado, registrar_slash, configurar_prefijo, registrar_manejador, iniciar_bot_real, mantener_activo" << std::endl;
+        default:
+            break;
     }
     
     currentLine = listoLine;
 }
 
-void CommandExecutor::executeLine(const std::vector<std::string>& lines, int& currentLine) {
-    std::string originalLine = lines[currentLine];
-    std::string line = Utils::trim(Utils::removeComments(originalLine));
-    
-    if (line.empty()) return;
+void CommandExecutor::executeCommand(const std::vector<Command>& code, int& currentLine, int endLine) {
+    const Command& cmd = code[currentLine];
 
     try {
-        if (line.find("hornear ") == 0) {
-            executeHornear(line.substr(8));
-        } else if (line.find("ingrediente ") == 0) {
-            executeIngrediente(line.substr(12));
-        } else if (line.find("probar ") == 0) {
-            executeConditional(lines, currentLine);
-        } else if (line.find("receta ") == 0 && line.find("(") != std::string::npos) {
-            executeRecetaDefinition(lines, currentLine);
-        } else if (line.find("cocinar ") == 0) {
-            executeCocinar(line.substr(8));
-        } else if (line.find("mostrador ") == 0) {
-            executeMostrador(line.substr(10));
-        } else if (line.find("escribir ") == 0) {
-            executeEscribir(line.substr(9));
-        } else if (line.find("libro ") == 0) {
-            executeLibro(line.substr(6));
-        } else if (line.find("receta ") == 0 && line.find("(") == std::string::npos) {
-            executeReceta(line.substr(7));
-        } else if (line.find("discord ") == 0) {
-            executeDiscord(line.substr(8));
-        } else if (line.find("juego ") == 0) {
-            executeJuego(line.substr(6));
-        } else if (line.find("objeto ") == 0) {
-            executeObjeto(line.substr(7));
-        } else if (line.find("mover ") == 0) {
-            executeMover(line.substr(6));
-        } else if (line.find("posicionar ") == 0) {
-            executePosicionar(line.substr(11));
-        } else if (line.find("ocultar ") == 0) {
-            executeOcultar(line.substr(8));
-        } else if (line != "listo" && line != "alternativa:" && line.find("sino ") != 0) {
-            std::cerr << "Error: Linea no reconocida: " << line << std::endl;
+        switch (cmd.type) {
+            case CommandType::Hornear: executeHornear(cmd); break;
+            case CommandType::Ingrediente: executeIngrediente(cmd); break;
+            case CommandType::Probar: executeConditional(code, currentLine, endLine); break;
+            case CommandType::Repetir:
+            case CommandType::Mientras:
+            case CommandType::ParaCada: executeLoop(code, currentLine, endLine); break;
+            case CommandType::RecetaDefinicion: executeRecetaDefinition(code, currentLine, endLine); break;
+            case CommandType::Cocinar: executeCocinar(cmd); break;
+            case CommandType::Mostrador: executeMostrador(cmd); break;
+            case CommandType::Escribir: executeEscribir(cmd); break;
+            case CommandType::Libro: executeLibro(cmd); break;
+            case CommandType::Receta: executeReceta(cmd.args); break;
+            case CommandType::Discord: executeDiscord(cmd); break;
+            case CommandType::Juego: executeJuego(cmd); break;
+            case CommandType::Objeto: executeObjeto(cmd); break;
+            case CommandType::Mover: executeMover(cmd); break;
+            case CommandType::Posicionar: executePosicionar(cmd); break;
+            case CommandType::Ocultar: executeOcultar(cmd); break;
+            case CommandType::Quitar: executeQuitar(cmd); break;
+            case CommandType::Semilla: executeSemilla(cmd); break;
+            case CommandType::Sino:
+            case CommandType::Alternativa:
+            case CommandType::Listo:
+                break;
+            case CommandType::Desconocido:
+                std::cerr << "Error: Linea no reconocida: " << cmd.text << std::endl;
+                break;
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error en la linea " << (currentLine + 1) << ": " << e.what() << std::endl;
+        std::cerr << "Error en la linea " << cmd.line << ": " << e.what() << std::endl;
+        // Si falla la cabecera de un bucle, el bucle no se ejecuta
+        bool loop = cmd.type == CommandType::Repetir || cmd.type == CommandType::ParaCada;
+        if (loop && cmd.blockEnd != -1) {
+            currentLine = cmd.blockEnd;
+        }
     }
+}
+
+void CommandExecutor::executeRange(const std::vector<Command>& code, int startLine, int endLine) {
+    for (int i = startLine; i < endLine; i++) {
+        executeCommand(code, i, endLine);
+    }
+}
+
+void CommandExecutor::executeProgram(std::shared_ptr<const std::vector<Command>> code) {
+    loadProgram(code);
+    executeRange(*program, 0, static_cast<int>(program->size()));
 }
\ No newline at end of file
@@ -2,7 +2,9 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <memory>
 #include "structures.h"
+#include "symbol_table.h"
 #include "expressions.h"
 #include "window_manager.h"
 #include "book_manager.h"
@@ -10,42 +12,56 @@
 
 class CommandExecutor {
 private:
-    std::map<std::string, int> intVariables;
-    std::map<std::string, std::string> stringVariables;
-    std::map<std::string, double> floatVariables;
-    std::map<std::string, std::vector<std::string>> arrayVariables;
-    std::map<std::string, Function> functions;
+    SymbolTable symbols;
+    std::map<int, Function> functions;    // por nombre internado
+    std::shared_ptr<const std::vector<Command>> program;
     
     ExpressionEvaluator* evaluator;
     WindowManager* windowManager;
     BookManager* bookManager;
     DependencyManager* dependencyManager;
-
-    std::string handleInputFunction(const std::string& funcCall);
-    int findMatchingListo(const std::vector<std::string>& lines, int startLine);
     
+    bool conditionHolds(const Command& cmd);
+    const ExprNode* exprOf(const Command& cmd);
+    const ExprNode* argsOf(const Command& cmd);
+    const ExprNode* indexOf(const Command& cmd);
+    const ExprNode* paramOf(const Command& cmd, size_t index);
+
 public:
     CommandExecutor();
     ~CommandExecutor();
 
-    void executeHornear(const std::string& args);
-    void executeMostrador(const std::string& args);
-    void executeJuego(const std::string& args);
-    void executeObjeto(const std::string& args);
-    void executeMover(const std::string& args);
-    void executeColision(const std::string& args, bool& result);
-    void executeOcultar(const std::string& args);
-    void executePosicionar(const std::string& args);
-    void executeEscribir(const std::string& args);
-    void executeLibro(const std::string& args);
+    void executeHornear(const Command& cmd);
+    void executeMostrador(const Command& cmd);
+    void executeJuego(const Command& cmd);
+    void executeObjeto(const Command& cmd);
+    void executeMover(const Command& cmd);
+    void executeColision(const Command& cmd, bool& result);
+    void executeOcultar(const Command& cmd);
+    void executePosicionar(const Command& cmd);
+    void executeEscribir(const Command& cmd);
+    void executeLibro(const Command& cmd);
     void executeReceta(const std::string& args);
-    void executeDiscord(const std::string& args);
-    void executeIngrediente(const std::string& args);
-    void executeRecetaDefinition(const std::vector<std::string>& lines, int& currentLine);
-    void executeCocinar(const std::string& args);
-    void executeConditional(const std::vector<std::string>& lines, int& currentLine);
-    void executeLine(const std::vector<std::string>& lines, int& currentLine);
+    void executeDiscord(const Command& cmd);
+    void executeIngrediente(const Command& cmd);
+    void executeQuitar(const Command& cmd);
+    void executeSemilla(const Command& cmd);
+    void executeRecetaDefinition(const std::vector<Command>& code, int& currentLine, int endLine);
+    void executeCocinar(const Command& cmd);
+    void executeConditional(const std::vector<Command>& code, int& currentLine, int endLine);
+    bool evaluateBranchCondition(const Command& cmd);
+    void executeLoop(const std::vector<Command>& code, int& currentLine, int endLine);
+    long long evaluateRepeatCount(const Command& cmd);
+    Value evaluateForEachList(const Command& cmd);
+    void assignLoopVariable(const Command& cmd, const Value& list, size_t index);
+    bool enterReceta(const Command& cmd, Function& func);
+    void leaveReceta();
+    void executeCommand(const std::vector<Command>& code, int& currentLine, int endLine);
+    void executeRange(const std::vector<Command>& code, int startLine, int endLine);
+    SymbolTable& getSymbols() { return symbols; }
+    void loadProgram(std::shared_ptr<const std::vector<Command>> code) { program = code; }
+    void executeProgram(std::shared_ptr<const std::vector<Command>> code);
     
     void runMessageLoop() { windowManager->runMessageLoop(); }
     bool hasWindows() { return !windowManager->getWindows().empty(); }
-};
\ No newline at end of file
+};
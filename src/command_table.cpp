@@ -0,0 +1,77 @@
+#include "command_table.h"
+
+static void registerBuiltins() {
+    CommandTable::registerCommand("hornear", CommandType::Hornear, CommandSyntax::Texto);
+    CommandTable::registerCommand("ingrediente", CommandType::Ingrediente, CommandSyntax::Especial);
+    CommandTable::registerCommand("probar", CommandType::Probar, CommandSyntax::Especial);
+    CommandTable::registerCommand("sino", CommandType::Sino, CommandSyntax::Especial);
+    CommandTable::registerCommand("alternativa", CommandType::Alternativa, CommandSyntax::Especial);
+    CommandTable::registerCommand("listo", CommandType::Listo, CommandSyntax::Especial);
+    CommandTable::registerCommand("repetir", CommandType::Repetir, CommandSyntax::Especial);
+    CommandTable::registerCommand("mientras", CommandType::Mientras, CommandSyntax::Especial);
+    CommandTable::registerCommand("para", CommandType::ParaCada, CommandSyntax::Especial);
+    CommandTable::registerCommand("receta", CommandType::Receta, CommandSyntax::Especial);
+    CommandTable::registerCommand("cocinar", CommandType::Cocinar, CommandSyntax::Especial);
+    CommandTable::registerCommand("mostrador", CommandType::Mostrador, CommandSyntax::Argumentos);
+    CommandTable::registerCommand("escribir", CommandType::Escribir, CommandSyntax::Argumentos);
+    CommandTable::registerCommand("libro", CommandType::Libro, CommandSyntax::Argumentos);
+    CommandTable::registerCommand("discord", CommandType::Discord, CommandSyntax::Argumentos);
+    CommandTable::registerCommand("juego", CommandType::Juego, CommandSyntax::Argumentos);
+    CommandTable::registerCommand("objeto", CommandType::Objeto, CommandSyntax::Argumentos);
+    CommandTable::registerCommand("mover", CommandType::Mover, CommandSyntax::Argumentos);
+    CommandTable::registerCommand("posicionar", CommandType::Posicionar, CommandSyntax::Argumentos);
+    CommandTable::registerCommand("ocultar", CommandType::Ocultar, CommandSyntax::Argumentos);
+    CommandTable::registerCommand("quitar", CommandType::Quitar, CommandSyntax::Especial);
+    CommandTable::registerCommand("semilla", CommandType::Semilla, CommandSyntax::Texto);
+    
+    // Palabras reservadas que no empiezan ninguna linea
+    const char* words[] = {
+        "pedir_numero", "pedir_nombre", "entero", "texto", "decimal", "lista",
+        "boton", "entrada", "dibujar", "colision", "tecla", "temporizador",
+        "aleatorio", "objeto_x", "objeto_y", "veces", "cada"
+    };
+    for (const char* word : words) {
+        CommandTable::registerKeyword(word);
+    }
+}
+
+std::unordered_map<std::string, CommandSpec>& CommandTable::commands() {
+    static std::unordered_map<std::string, CommandSpec> table;
+    return table;
+}
+
+std::unordered_set<std::string>& CommandTable::reserved() {
+    static std::unordered_set<std::string> words;
+    return words;
+}
+
+// Los comandos propios se cargan en el primer uso, sin depender del orden
+// de inicializacion de los estaticos
+void CommandTable::loadBuiltins() {
+    static bool loaded = false;
+    if (loaded) return;
+    loaded = true;
+    registerBuiltins();
+}
+
+void CommandTable::registerCommand(const std::string& keyword, CommandType type, CommandSyntax syntax) {
+    loadBuiltins();
+    commands()[keyword] = {type, syntax};
+    reserved().insert(keyword);
+}
+
+void CommandTable::registerKeyword(const std::string& word) {
+    loadBuiltins();
+    reserved().insert(word);
+}
+
+const CommandSpec* CommandTable::find(const std::string& keyword) {
+    loadBuiltins();
+    auto it = commands().find(keyword);
+    return it != commands().end() ? &it->second : nullptr;
+}
+
+bool CommandTable::isKeyword(const std::string& word) {
+    loadBuiltins();
+    return reserved().count(word) > 0;
+}
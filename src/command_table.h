@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "structures.h"
+
+// Como se leen los argumentos que siguen a la palabra clave
+enum class CommandSyntax : unsigned char {
+    Especial,    // el parser los trata uno a uno (ingrediente, probar, receta...)
+    Texto,       // el resto de la linea tal cual
+    Argumentos   // lista separada por comas
+};
+
+struct CommandSpec {
+    CommandType type;
+    CommandSyntax syntax;
+};
+
+// Tabla unica de comandos y palabras reservadas: el parser despacha por la
+// primera palabra de la linea con una sola busqueda
+class CommandTable {
+private:
+    static std::unordered_map<std::string, CommandSpec>& commands();
+    static std::unordered_set<std::string>& reserved();
+    static void loadBuiltins();
+
+public:
+    static void registerCommand(const std::string& keyword, CommandType type, CommandSyntax syntax);
+    static void registerKeyword(const std::string& word);
+    
+    static const CommandSpec* find(const std::string& keyword);
+    static bool isKeyword(const std::string& word);
+};
@@ -36,22 +36,22 @@ bool DependencyManager::loadDependencyInfo(const std::string& depName, std::map<
     
     std::string line;
     while (std::getline(file, line)) {
-        line = Utils::trim(line);
-        if (line.empty() || line[0] == '#') continue;
+        std::string_view entry = Utils::trim(line);
+        if (entry.empty() || entry[0] == '#') continue;
         
-        size_t firstColon = line.find(':');
-        size_t secondColon = line.find(':', firstColon + 1);
+        size_t firstColon = entry.find(':');
+        size_t secondColon = entry.find(':', firstColon + 1);
         
-        if (firstColon != std::string::npos && secondColon != std::string::npos) {
-            std::string key = Utils::trim(line.substr(0, firstColon));
-            std::string value = line.substr(secondColon + 1);
+        if (firstColon != std::string_view::npos && secondColon != std::string_view::npos) {
+            std::string key(Utils::trim(entry.substr(0, firstColon)));
+            std::string_view value = entry.substr(secondColon + 1);
             
             // Remover comillas si las tiene
             if (value.length() >= 2 && value.front() == '"' && value.back() == '"') {
                 value = value.substr(1, value.length() - 2);
             }
             
-            info[key] = value;
+            info[key] = std::string(value);
         }
     }
     
@@ -0,0 +1,125 @@
+#include "dictionary.h"
+#include <functional>
+
+size_t Dictionary::hashOf(std::string_view key) {
+    return std::hash<std::string_view>()(key);
+}
+
+// Casilla de la clave, o control.size() si no esta
+size_t Dictionary::probe(std::string_view key, size_t hash) const {
+    if (control.empty()) return 0;
+    
+    size_t mask = control.size() - 1;
+    uint8_t tag = static_cast<uint8_t>(hash & 0x7F);
+    for (size_t pos = (hash >> 7) & mask;; pos = (pos + 1) & mask) {
+        uint8_t c = control[pos];
+        if (c == Empty) return control.size();
+        if (c == tag && entries[slots[pos]].key == key) return pos;
+    }
+}
+
+// Reconstruye la tabla con la capacidad dada y descarta las entradas borradas
+void Dictionary::rehash(size_t capacity) {
+    std::vector<Entry> kept;
+    kept.reserve(live);
+    for (Entry& entry : entries) {
+        if (entry.alive) kept.push_back(std::move(entry));
+    }
+    entries = std::move(kept);
+    
+    control.assign(capacity, Empty);
+    slots.assign(capacity, 0);
+    used = entries.size();
+    
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < entries.size(); i++) {
+        size_t hash = hashOf(entries[i].key);
+        size_t pos = (hash >> 7) & mask;
+        while (control[pos] != Empty) pos = (pos + 1) & mask;
+        control[pos] = static_cast<uint8_t>(hash & 0x7F);
+        slots[pos] = static_cast<uint32_t>(i);
+    }
+}
+
+const Value* Dictionary::find(std::string_view key) const {
+    size_t pos = probe(key, hashOf(key));
+    return pos < control.size() ? &entries[slots[pos]].value : nullptr;
+}
+
+void Dictionary::set(const std::string& key, Value value) {
+    size_t hash = hashOf(key);
+    size_t pos = probe(key, hash);
+    if (pos < control.size()) {
+        entries[slots[pos]].value = std::move(value);
+        return;
+    }
+    
+    // Se mantiene al menos una cuarta parte de casillas vacias para que las busquedas terminen pronto
+    if ((used + 1) * 4 > control.size() * 3) {
+        size_t capacity = control.empty() ? 8 : control.size();
+        while ((live + 1) * 2 > capacity) capacity *= 2;
+        rehash(capacity);
+    }
+    
+    size_t mask = control.size() - 1;
+    pos = (hash >> 7) & mask;
+    while (control[pos] != Empty && control[pos] != Deleted) pos = (pos + 1) & mask;
+    if (control[pos] == Empty) used++;
+    control[pos] = static_cast<uint8_t>(hash & 0x7F);
+    slots[pos] = static_cast<uint32_t>(entries.size());
+    entries.push_back({key, std::move(value), true});
+    live++;
+}
+
+bool Dictionary::erase(std::string_view key) {
+    size_t pos = probe(key, hashOf(key));
+    if (pos >= control.size()) return false;
+    
+    Entry& entry = entries[slots[pos]];
+    entry.alive = false;
+    entry.key.clear();
+    entry.value = Value();
+    control[pos] = Deleted;
+    live--;
+    
+    // Con muchas entradas borradas se compacta para no recorrer huecos
+    if (entries.size() > 16 && live * 2 < entries.size()) {
+        rehash(control.size());
+    }
+    return true;
+}
+
+std::vector<std::string> Dictionary::keys() const {
+    std::vector<std::string> result;
+    result.reserve(live);
+    for (const Entry& entry : entries) {
+        if (entry.alive) result.push_back(entry.key);
+    }
+    return result;
+}
+
+// {"clave": valor, ...}; los textos van entre comillas como en el literal
+void Dictionary::appendTo(std::string& out) const {
+    out += '{';
+    bool first = true;
+    for (const Entry& entry : entries) {
+        if (!entry.alive) continue;
+        if (!first) out += ", ";
+        first = false;
+        out += '"';
+        out += entry.key;
+        out += "\": ";
+        if (entry.value.getType() == ValueType::Texto) {
+            out += '"';
+            out += entry.value.asText();
+            out += '"';
+        } else if (entry.value.getType() == ValueType::Lista) {
+            out += '[';
+            entry.value.appendTo(out);
+            out += ']';
+        } else {
+            entry.value.appendTo(out);
+        }
+    }
+    out += '}';
+}
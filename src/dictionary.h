@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "value.h"
+
+// Diccionario de textos a valores con direccionamiento abierto.
+// Cada casilla tiene un byte de control (vacia, borrada o 7 bits del hash) que
+// descarta casi todas las claves sin compararlas; las entradas se guardan aparte
+// en orden de insercion, asi recorrer el diccionario es estable.
+class Dictionary {
+private:
+    static constexpr uint8_t Empty = 0x80;
+    static constexpr uint8_t Deleted = 0xFE;
+    
+    struct Entry {
+        std::string key;
+        Value value;
+        bool alive;
+    };
+    
+    std::vector<uint8_t> control;
+    std::vector<uint32_t> slots;    // posicion de la entrada de cada casilla ocupada
+    std::vector<Entry> entries;
+    size_t live = 0;
+    size_t used = 0;                // casillas ocupadas o borradas
+    
+    static size_t hashOf(std::string_view key);
+    size_t probe(std::string_view key, size_t hash) const;
+    void rehash(size_t capacity);
+
+public:
+    const Value* find(std::string_view key) const;
+    void set(const std::string& key, Value value);
+    bool erase(std::string_view key);
+    
+    size_t size() const { return live; }
+    std::vector<std::string> keys() const;
+    void appendTo(std::string& out) const;
+};
@@ -0,0 +1,343 @@
+#include "expression_parser.h"
+#include "utils.h"
+#include "string_table.h"
+#include <cctype>
+#include <iostream>
+
+static bool isIdentifierChar(char c) {
+    unsigned char uc = static_cast<unsigned char>(c);
+    return std::isalnum(uc) || c == '_' || uc >= 0x80;
+}
+
+ExpressionParser::ExpressionParser(const std::string& src, SymbolTable& syms)
+    : source(src), symbols(syms), pos(0), current{TokenType::Fin, 0, 0, ExprOp::Sumar} {}
+
+void ExpressionParser::advance() {
+    TokenType previous = current.type;
+    while (pos < source.length() && (source[pos] == ' ' || source[pos] == '\t')) {
+        pos++;
+    }
+    
+    current = {TokenType::Fin, pos, 0, ExprOp::Sumar};
+    if (pos >= source.length()) return;
+    
+    size_t start = pos;
+    char c = source[pos];
+    char next = pos + 1 < source.length() ? source[pos + 1] : '\0';
+    
+    if (std::isdigit(static_cast<unsigned char>(c)) || (c == '.' && std::isdigit(static_cast<unsigned char>(next)))) {
+        while (pos < source.length() && std::isdigit(static_cast<unsigned char>(source[pos]))) pos++;
+        if (pos < source.length() && source[pos] == '.') {
+            pos++;
+            while (pos < source.length() && std::isdigit(static_cast<unsigned char>(source[pos]))) pos++;
+        }
+        current = {TokenType::Numero, start, pos - start, ExprOp::Sumar};
+        return;
+    }
+    
+    if (c == '"') {
+        pos++;
+        while (pos < source.length() && !(source[pos] == '"' && source[pos - 1] != '\\')) pos++;
+        if (pos >= source.length()) {
+            current.type = TokenType::Error;
+            return;
+        }
+        pos++;
+        current = {TokenType::Cadena, start, pos - start, ExprOp::Sumar};
+        return;
+    }
+    
+    if (isIdentifierChar(c)) {
+        while (pos < source.length() && isIdentifierChar(source[pos])) pos++;
+        current = {TokenType::Identificador, start, pos - start, ExprOp::Sumar};
+        return;
+    }
+    
+    // Un corchete justo despues de un valor es un indice: lista[i], texto[a:b]
+    bool afterValue = previous == TokenType::Identificador || previous == TokenType::ParenDer ||
+                      previous == TokenType::CorcheteDer || previous == TokenType::Lista ||
+                      previous == TokenType::Cadena || previous == TokenType::LlaveDer;
+    if (c == '[' && !afterValue) {
+        // La lista literal se toma entera hasta su corchete de cierre
+        int depth = 0;
+        bool inQuotes = false;
+        for (; pos < source.length(); pos++) {
+            if (source[pos] == '"') inQuotes = !inQuotes;
+            if (inQuotes) continue;
+            if (source[pos] == '[') depth++;
+            if (source[pos] == ']' && --depth == 0) break;
+        }
+        if (pos >= source.length()) {
+            current.type = TokenType::Error;
+            return;
+        }
+        pos++;
+        current = {TokenType::Lista, start, pos - start, ExprOp::Sumar};
+        return;
+    }
+    
+    pos++;
+    current.length = 1;
+    switch (c) {
+        case '+': current.type = TokenType::Operador; current.op = ExprOp::Sumar; return;
+        case '-': current.type = TokenType::Operador; current.op = ExprOp::Restar; return;
+        case '*': current.type = TokenType::Operador; current.op = ExprOp::Multiplicar; return;
+        case '/': current.type = TokenType::Operador; current.op = ExprOp::Dividir; return;
+        case '%': current.type = TokenType::Operador; current.op = ExprOp::Modulo; return;
+        case '(': current.type = TokenType::ParenIzq; return;
+        case ')': current.type = TokenType::ParenDer; return;
+        case ',': current.type = TokenType::Coma; return;
+        case '[': current.type = TokenType::CorcheteIzq; return;
+        case ']': current.type = TokenType::CorcheteDer; return;
+        case ':': current.type = TokenType::DosPuntos; return;
+        case '{': current.type = TokenType::LlaveIzq; return;
+        case '}': current.type = TokenType::LlaveDer; return;
+        default: break;
+    }
+    
+    bool hasEqual = next == '=';
+    if (hasEqual) {
+        pos++;
+        current.length = 2;
+    }
+    current.type = TokenType::Operador;
+    if (c == '=' && hasEqual) current.op = ExprOp::Igual;
+    else if (c == '!' && hasEqual) current.op = ExprOp::Distinto;
+    else if (c == '<') current.op = hasEqual ? ExprOp::MenorIgual : ExprOp::Menor;
+    else if (c == '>') current.op = hasEqual ? ExprOp::MayorIgual : ExprOp::Mayor;
+    else current.type = TokenType::Error;
+}
+
+int ExpressionParser::precedence(const Token& token) {
+    if (token.type == TokenType::Coma) return 1;
+    if (token.type != TokenType::Operador) return 0;
+    
+    switch (token.op) {
+        case ExprOp::Igual:
+        case ExprOp::Distinto:
+        case ExprOp::Menor:
+        case ExprOp::Mayor:
+        case ExprOp::MenorIgual:
+        case ExprOp::MayorIgual:
+            return 2;
+        case ExprOp::Sumar:
+        case ExprOp::Restar:
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+std::unique_ptr<ExprNode> ExpressionParser::parseCall(const std::string& name) {
+    auto node = std::make_unique<ExprNode>();
+    node->kind = ExprKind::Llamada;
+    node->text = name;
+    
+    node->builtin = BuiltinTable::find(name);
+    if (!node->builtin) return nullptr;
+    
+    advance();
+    if (current.type != TokenType::ParenDer) {
+        while (true) {
+            std::unique_ptr<ExprNode> arg = parseExpression(2);
+            if (!arg) return nullptr;
+            node->children.push_back(std::move(arg));
+            if (current.type != TokenType::Coma) break;
+            advance();
+        }
+    }
+    
+    if (current.type != TokenType::ParenDer) return nullptr;
+    advance();
+    
+    size_t count = node->children.size();
+    if (count < node->builtin->minArgs || count > node->builtin->maxArgs) {
+        std::cerr << "Error: " << name << " recibe ";
+        if (node->builtin->minArgs == node->builtin->maxArgs) std::cerr << node->builtin->minArgs;
+        else std::cerr << "entre " << node->builtin->minArgs << " y " << node->builtin->maxArgs;
+        std::cerr << " argumentos (tiene " << count << ")" << std::endl;
+        return nullptr;
+    }
+    return node;
+}
+
+// Uno o varios [i] o [a:b] seguidos detras de un valor
+std::unique_ptr<ExprNode> ExpressionParser::parseIndex(std::unique_ptr<ExprNode> target) {
+    while (current.type == TokenType::CorcheteIzq) {
+        advance();
+        auto node = std::make_unique<ExprNode>();
+        node->kind = ExprKind::Indice;
+        node->children.push_back(std::move(target));
+        
+        std::unique_ptr<ExprNode> start;
+        if (current.type != TokenType::DosPuntos) {
+            start = parseExpression(2);
+            if (!start) return nullptr;
+        }
+        
+        if (current.type == TokenType::DosPuntos) {
+            advance();
+            node->kind = ExprKind::Rebanada;
+            std::unique_ptr<ExprNode> end;
+            if (current.type != TokenType::CorcheteDer) {
+                end = parseExpression(2);
+                if (!end) return nullptr;
+            }
+            for (std::unique_ptr<ExprNode>* bound : {&start, &end}) {
+                if (!*bound) {
+                    *bound = std::make_unique<ExprNode>();
+                    (*bound)->kind = ExprKind::Constante;
+                }
+            }
+            node->children.push_back(std::move(start));
+            node->children.push_back(std::move(end));
+        } else {
+            if (!start) return nullptr;
+            node->children.push_back(std::move(start));
+        }
+        
+        if (current.type != TokenType::CorcheteDer) return nullptr;
+        advance();
+        target = std::move(node);
+    }
+    return target;
+}
+
+// {clave: valor, ...} con el primer corchete ya leido
+std::unique_ptr<ExprNode> ExpressionParser::parseDictionary() {
+    auto node = std::make_unique<ExprNode>();
+    node->kind = ExprKind::Diccionario;
+    
+    if (current.type != TokenType::LlaveDer) {
+        while (true) {
+            std::unique_ptr<ExprNode> key = parseExpression(2);
+            if (!key || current.type != TokenType::DosPuntos) return nullptr;
+            advance();
+            std::unique_ptr<ExprNode> value = parseExpression(2);
+            if (!value) return nullptr;
+            node->children.push_back(std::move(key));
+            node->children.push_back(std::move(value));
+            if (current.type != TokenType::Coma) break;
+            advance();
+        }
+    }
+    
+    if (current.type != TokenType::LlaveDer) return nullptr;
+    advance();
+    return node;
+}
+
+std::unique_ptr<ExprNode> ExpressionParser::parsePrefix() {
+    Token token = current;
+    auto node = std::make_unique<ExprNode>();
+    node->kind = ExprKind::Constante;
+    
+    switch (token.type) {
+        case TokenType::Numero: {
+            advance();
+            std::string text = tokenText(token);
+            long long intValue;
+            double decimalValue;
+            if (text.find('.') != std::string::npos) {
+                if (!Utils::parseDecimal(text, decimalValue)) return nullptr;
+                node->constant = Value::fromFloat(decimalValue);
+            } else {
+                if (!Utils::parseInteger(text, intValue)) return nullptr;
+                node->constant = Value::fromInt(intValue);
+            }
+            return node;
+        }
+        case TokenType::Cadena:
+            advance();
+            node->constant = Value::fromText(source.substr(token.start + 1, token.length - 2));
+            node->symbol = StringTable::intern(node->constant.asText());
+            return node;
+        case TokenType::Lista: {
+            advance();
+            std::vector<std::string_view> items = Utils::parseArray(std::string_view(source).substr(token.start, token.length));
+            node->constant = Value::fromList(std::vector<std::string>(items.begin(), items.end()));
+            return node;
+        }
+        case TokenType::Identificador: {
+            advance();
+            std::string name = tokenText(token);
+            if (current.type == TokenType::ParenIzq) {
+                return parseCall(name);
+            }
+            node->kind = ExprKind::Variable;
+            node->slot = symbols.resolve(name);
+            node->symbol = StringTable::intern(name);
+            node->text = name;
+            return node;
+        }
+        case TokenType::Operador:
+            if (token.op == ExprOp::Restar || token.op == ExprOp::Sumar) {
+                advance();
+                std::unique_ptr<ExprNode> operand = parseExpression(5);
+                if (!operand || token.op == ExprOp::Sumar) return operand;
+                node->kind = ExprKind::Negativo;
+                node->children.push_back(std::move(operand));
+                return node;
+            }
+            return nullptr;
+        case TokenType::LlaveIzq:
+            advance();
+            return parseDictionary();
+        case TokenType::ParenIzq: {
+            advance();
+            std::unique_ptr<ExprNode> inner = parseExpression(2);
+            if (!inner || current.type != TokenType::ParenDer) return nullptr;
+            advance();
+            return inner;
+        }
+        default:
+            return nullptr;
+    }
+}
+
+std::unique_ptr<ExprNode> ExpressionParser::parseExpression(int minPrecedence) {
+    std::unique_ptr<ExprNode> left = parsePrefix();
+    if (left) left = parseIndex(std::move(left));
+    if (!left) return nullptr;
+    
+    while (true) {
+        int prec = precedence(current);
+        if (prec == 0 || prec < minPrecedence) break;
+        
+        Token opToken = current;
+        advance();
+        std::unique_ptr<ExprNode> right = parseExpression(prec + 1);
+        if (!right) return nullptr;
+        
+        if (opToken.type == TokenType::Coma) {
+            if (left->kind != ExprKind::Concatenar) {
+                auto concat = std::make_unique<ExprNode>();
+                concat->kind = ExprKind::Concatenar;
+                concat->children.push_back(std::move(left));
+                left = std::move(concat);
+            }
+            left->children.push_back(std::move(right));
+        } else {
+            auto binary = std::make_unique<ExprNode>();
+            binary->kind = ExprKind::Binaria;
+            binary->op = opToken.op;
+            binary->children.push_back(std::move(left));
+            binary->children.push_back(std::move(right));
+            left = std::move(binary);
+        }
+    }
+    
+    return left;
+}
+
+std::unique_ptr<ExprNode> ExpressionParser::parse() {
+    advance();
+    std::unique_ptr<ExprNode> node = parseExpression(1);
+    
+    if (!node || current.type != TokenType::Fin) {
+        node = std::make_unique<ExprNode>();
+        node->kind = ExprKind::Crudo;
+        node->text = std::string(Utils::trim(source));
+    }
+    return node;
+}
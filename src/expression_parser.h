@@ -0,0 +1,73 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include "value.h"
+#include "symbol_table.h"
+#include "builtin_table.h"
+
+enum class ExprKind : unsigned char {
+    Constante,   // numero, texto o lista literal
+    Variable,
+    Negativo,
+    Binaria,
+    Concatenar,  // partes separadas por ", " (se escriben seguidas)
+    Llamada,
+    Indice,      // lista[i]
+    Rebanada,    // lista[a:b]; un limite omitido es una constante vacia
+    Diccionario, // {clave: valor, ...}; los hijos alternan clave y valor
+    Crudo        // texto que no es una expresion valida: se usa tal cual
+};
+
+enum class ExprOp : unsigned char {
+    Sumar, Restar, Multiplicar, Dividir, Modulo,
+    Igual, Distinto, Menor, Mayor, MenorIgual, MayorIgual
+};
+
+// Nodo del arbol de una expresion; se construye una vez por texto y se reutiliza
+struct ExprNode {
+    ExprKind kind;
+    ExprOp op = ExprOp::Sumar;
+    const BuiltinSpec* builtin = nullptr;   // llamada: funcion ya resuelta
+    int slot = -1;
+    int symbol = -1;    // texto literal o nombre de variable internado
+    Value constant;
+    std::string text;   // nombre de variable o funcion, o el texto crudo
+    std::vector<std::unique_ptr<ExprNode>> children;
+};
+
+// Analizador por precedencia de operadores (Pratt)
+class ExpressionParser {
+private:
+    enum class TokenType {
+        Numero, Cadena, Identificador, Operador, ParenIzq, ParenDer, Coma, Lista,
+        CorcheteIzq, CorcheteDer, DosPuntos, LlaveIzq, LlaveDer, Fin, Error
+    };
+    
+    struct Token {
+        TokenType type;
+        size_t start;
+        size_t length;
+        ExprOp op;
+    };
+    
+    const std::string& source;
+    SymbolTable& symbols;
+    size_t pos;
+    Token current;
+    
+    void advance();
+    std::string tokenText(const Token& token) const { return source.substr(token.start, token.length); }
+    static int precedence(const Token& token);
+    
+    std::unique_ptr<ExprNode> parseExpression(int minPrecedence);
+    std::unique_ptr<ExprNode> parsePrefix();
+    std::unique_ptr<ExprNode> parseCall(const std::string& name);
+    std::unique_ptr<ExprNode> parseIndex(std::unique_ptr<ExprNode> target);
+    std::unique_ptr<ExprNode> parseDictionary();
+
+public:
+    ExpressionParser(const std::string& source, SymbolTable& symbols);
+    
+    std::unique_ptr<ExprNode> parse();
+};
@@ -1,328 +1,698 @@
 #include "expressions.h"
 #include "utils.h"
+#include "string_table.h"
+#include "numeric_kernels.h"
+#include "dictionary.h"
 #include <iostream>
-#include <random>
 #include <algorithm>
 #include <cmath>
-#include <sstream>
-
-ExpressionEvaluator::ExpressionEvaluator(
-    std::map<std::string, int>& intVars,
-    std::map<std::string, std::string>& stringVars,
-    std::map<std::string, double>& floatVars,
-    std::map<std::string, std::vector<std::string>>& arrayVars,
-    std::vector<WindowInfo>& wins
-) : intVariables(intVars), stringVariables(stringVars), floatVariables(floatVars), 
-    arrayVariables(arrayVars), windows(wins) {}
-
-std::string ExpressionEvaluator::evaluateStringExpression(const std::string& expr) {
-    std::string trimmed = Utils::trim(expr);
-    
-    // String simple con comillas sin concatenaciÃ³n
-    if (trimmed.length() >= 2 && trimmed.front() == '"' && trimmed.back() == '"') {
-        if (trimmed.find(" + ") == std::string::npos && trimmed.find(", ") == std::string::npos) {
-            return trimmed.substr(1, trimmed.length() - 2);
-        }
+
+ExpressionEvaluator::ExpressionEvaluator(SymbolTable& syms, std::vector<WindowInfo>& wins)
+    : symbols(syms), windows(wins) {}
+
+const ExprNode* ExpressionEvaluator::getExpression(const std::string& expr) {
+    auto it = cache.find(expr);
+    if (it != cache.end()) {
+        return it->second.get();
     }
     
-    // ARREGLO CRÃTICO: DetecciÃ³n mejorada de concatenaciÃ³n
-    std::vector<std::string> parts;
-    std::string current = "";
-    bool inQuotes = false;
-    int parenDepth = 0;
+    ExpressionParser parser(expr, symbols);
+    std::unique_ptr<ExprNode> node = parser.parse();
+    const ExprNode* result = node.get();
+    cache.emplace(expr, std::move(node));
+    return result;
+}
+
+// Arbol de una expresion de un comando: se busca por su texto solo la primera vez
+const ExprNode* ExpressionEvaluator::expression(const std::string& expr, const ExprNode*& tree) {
+    if (!tree) {
+        tree = getExpression(expr);
+    }
+    return tree;
+}
+
+const Value* ExpressionEvaluator::peek(const ExprNode* node) const {
+    if (node->kind == ExprKind::Constante) return &node->constant;
+    if (node->kind == ExprKind::Variable) return &symbols.at(node->slot);
+    return nullptr;
+}
+
+std::string ExpressionEvaluator::textOf(const ExprNode* node) {
+    // Un texto ya guardado se copia tal cual; lo demas se construye con una sola reserva
+    const Value* value = peek(node);
+    if (value && value->getType() == ValueType::Texto) {
+        return std::string(value->asText());
+    }
     
-    for (size_t i = 0; i < trimmed.length(); i++) {
-        char c = trimmed[i];
-        
-        // Manejar comillas
-        if (c == '"' && (i == 0 || trimmed[i-1] != '\\')) {
-            inQuotes = !inQuotes;
-            current += c;
-            continue;
-        }
-        
-        // Manejar parÃ©ntesis solo fuera de comillas
-        if (!inQuotes) {
-            if (c == '(') parenDepth++;
-            else if (c == ')') parenDepth--;
+    std::string result;
+    result.reserve(measureText(node));
+    appendText(node, result);
+    return result;
+}
+
+// "+" concatena en cuanto uno de los lados es texto o lista de textos
+bool ExpressionEvaluator::producesText(const ExprNode* node) const {
+    switch (node->kind) {
+        case ExprKind::Constante:
+        case ExprKind::Variable: {
+            const Value* value = peek(node);
+            return value->getType() == ValueType::Texto ||
+                   (value->getType() == ValueType::Lista && !value->isNumericList());
         }
-        
-        // Solo procesar operadores fuera de comillas y parÃ©ntesis
-        if (!inQuotes && parenDepth == 0) {
-            // Buscar " + " para concatenaciÃ³n
-            if (i >= 1 && i + 1 < trimmed.length() && 
-                trimmed.substr(i-1, 3) == " + ") {
-                // Retroceder para no incluir el espacio antes del +
-                if (!current.empty() && current.back() == ' ') {
-                    current.pop_back();
+        case ExprKind::Concatenar:
+        case ExprKind::Crudo:
+            return true;
+        case ExprKind::Binaria:
+            return node->op == ExprOp::Sumar &&
+                   (producesText(node->children[0].get()) || producesText(node->children[1].get()));
+        case ExprKind::Indice: {
+            // En una lista de textos tambien puede haber numeros: si se puede, se mira el elemento
+            const ExprNode* target = node->children[0].get();
+            if (producesNumericList(target)) return false;
+            const Value* list = peek(target);
+            const Value* index = peek(node->children[1].get());
+            if (list && index && list->getType() == ValueType::Diccionario) {
+                const Value* item = list->asDictionary().find(index->toString());
+                return !item || item->getType() == ValueType::Texto ||
+                       (item->getType() == ValueType::Lista && !item->isNumericList());
+            }
+            if (list && index && list->getType() == ValueType::Lista && index->isNumeric()) {
+                long long i = index->toInt();
+                if (i < 0) i += static_cast<long long>(list->listSize());
+                if (i >= 0 && i < static_cast<long long>(list->listSize())) {
+                    return list->listItem(i).getType() == ValueType::Texto;
                 }
-                parts.push_back(Utils::trim(current));
-                current = "";
-                i++; // Saltar el espacio despuÃ©s del +
-                continue;
             }
-            // Buscar ", " para separaciÃ³n
-            else if (c == ',' && i + 1 < trimmed.length() && trimmed[i+1] == ' ') {
-                parts.push_back(Utils::trim(current));
-                current = "";
-                i++; // Saltar el espacio despuÃ©s de la coma
-                continue;
+            return true;
+        }
+        case ExprKind::Rebanada:
+            return producesText(node->children[0].get());
+        case ExprKind::Llamada:
+            return node->builtin->result == BuiltinResult::Texto ||
+                   (node->builtin->result == BuiltinResult::ComoPrimerArgumento && producesText(node->children[0].get()));
+        default:
+            return false;
+    }
+}
+
+// + - * / con una lista numerica se aplican elemento a elemento (salvo que haya texto de por medio)
+bool ExpressionEvaluator::producesNumericList(const ExprNode* node) const {
+    switch (node->kind) {
+        case ExprKind::Constante:
+        case ExprKind::Variable:
+            return peek(node)->isNumericList();
+        case ExprKind::Llamada:
+            return node->builtin->result == BuiltinResult::ListaNumerica ||
+                   (node->builtin->result == BuiltinResult::ComoPrimerArgumento &&
+                    producesNumericList(node->children[0].get()));
+        case ExprKind::Rebanada:
+            return producesNumericList(node->children[0].get());
+        case ExprKind::Binaria: {
+            if (node->op > ExprOp::Dividir) return false;
+            const ExprNode* left = node->children[0].get();
+            const ExprNode* right = node->children[1].get();
+            return (producesNumericList(left) || producesNumericList(right)) &&
+                   !producesText(left) && !producesText(right);
+        }
+        default:
+            return false;
+    }
+}
+
+// Cota de la longitud del texto, para reservar una vez antes de escribir
+size_t ExpressionEvaluator::measureText(const ExprNode* node) const {
+    switch (node->kind) {
+        case ExprKind::Constante:
+            return node->constant.textLength();
+        case ExprKind::Variable: {
+            const Value& var = symbols.at(node->slot);
+            return var.isEmpty() ? node->text.length() : var.textLength();
+        }
+        case ExprKind::Concatenar: {
+            size_t length = 0;
+            for (const auto& child : node->children) {
+                length += measureText(child.get());
+            }
+            return length;
+        }
+        case ExprKind::Binaria:
+            if (producesText(node)) {
+                return measureText(node->children[0].get()) + measureText(node->children[1].get());
+            }
+            return 24;
+        case ExprKind::Crudo:
+            return node->text.length();
+        default:
+            return 24;
+    }
+}
+
+// Escribe el texto de la expresion al final de out, parte a parte
+void ExpressionEvaluator::appendText(const ExprNode* node, std::string& out) {
+    switch (node->kind) {
+        case ExprKind::Constante:
+            node->constant.appendTo(out);
+            return;
+        case ExprKind::Variable: {
+            // Una palabra sin definir se escribe tal cual, como siempre ha hecho hornear
+            const Value& var = symbols.at(node->slot);
+            if (var.isEmpty()) {
+                out += node->text;
+            } else {
+                var.appendTo(out);
             }
+            return;
         }
-        
-        current += c;
+        case ExprKind::Concatenar:
+            for (const auto& child : node->children) {
+                appendText(child.get(), out);
+            }
+            return;
+        case ExprKind::Binaria:
+            if (producesText(node)) {
+                // Con "+" una variable vacia no aporta nada
+                for (const auto& child : node->children) {
+                    if (child->kind == ExprKind::Variable && symbols.at(child->slot).isEmpty()) continue;
+                    appendText(child.get(), out);
+                }
+                return;
+            }
+            break;
+        case ExprKind::Crudo:
+            out += node->text;
+            return;
+        case ExprKind::Llamada:
+        case ExprKind::Indice:
+        case ExprKind::Rebanada:
+        case ExprKind::Diccionario:
+            evalValue(node).appendTo(out);
+            return;
+        default:
+            break;
     }
     
-    parts.push_back(Utils::trim(current));
+    if (producesNumericList(node)) {
+        evalValue(node).appendTo(out);
+        return;
+    }
+    Number n = evalNumber(node);
+    (n.isInt ? Value::fromInt(n.intValue) : Value::fromFloat(n.floatValue)).appendTo(out);
+}
+
+// Primera parte de una concatenacion ("a" en a + b + c o en a, b, c)
+const ExprNode* ExpressionEvaluator::firstTextPart(const ExprNode* node) const {
+    while (node->kind == ExprKind::Concatenar || (node->kind == ExprKind::Binaria && producesText(node))) {
+        node = node->children[0].get();
+    }
+    return node;
+}
+
+bool ExpressionEvaluator::readsSlot(const ExprNode* node, int slot, const ExprNode* skip) const {
+    if (node != skip && node->kind == ExprKind::Variable && node->slot == slot) {
+        return true;
+    }
+    for (const auto& child : node->children) {
+        if (readsSlot(child.get(), slot, skip)) return true;
+    }
+    return false;
+}
+
+size_t ExpressionEvaluator::measureRest(const ExprNode* node, const ExprNode* first) const {
+    if (node == first) return 0;
     
-    if (parts.size() == 1) {
-        return evaluateSinglePart(parts[0]);
+    size_t length = measureRest(node->children[0].get(), first);
+    for (size_t i = 1; i < node->children.size(); i++) {
+        length += measureText(node->children[i].get());
     }
+    return length;
+}
+
+// Escribe todas las partes de la concatenacion menos la primera
+void ExpressionEvaluator::appendRest(const ExprNode* node, const ExprNode* first, std::string& out) {
+    if (node == first) return;
     
-    // CRÃTICO: Concatenar todas las partes
-    std::string result = "";
-    for (size_t i = 0; i < parts.size(); i++) {
-        std::string partValue = evaluateSinglePart(parts[i]);
-        result += partValue;
+    appendRest(node->children[0].get(), first, out);
+    for (size_t i = 1; i < node->children.size(); i++) {
+        const ExprNode* child = node->children[i].get();
+        if (node->kind == ExprKind::Binaria && child->kind == ExprKind::Variable && symbols.at(child->slot).isEmpty()) continue;
+        appendText(child, out);
+    }
+}
+
+static KernelOp toKernelOp(ExprOp op) {
+    switch (op) {
+        case ExprOp::Restar: return KernelOp::Restar;
+        case ExprOp::Multiplicar: return KernelOp::Multiplicar;
+        case ExprOp::Dividir: return KernelOp::Dividir;
+        default: return KernelOp::Sumar;
+    }
+}
+
+ExpressionEvaluator::Number ExpressionEvaluator::toNumber(const Value& value) {
+    if (value.getType() == ValueType::Decimal) {
+        return {false, 0, value.asFloat()};
+    }
+    return {true, value.toInt(), 0.0};
+}
+
+ExpressionEvaluator::Number ExpressionEvaluator::arithmetic(ExprOp op, const Number& left, const Number& right) {
+    if (left.isInt && right.isInt) {
+        long long a = left.intValue;
+        long long b = right.intValue;
+        switch (op) {
+            case ExprOp::Sumar: return {true, a + b, 0.0};
+            case ExprOp::Restar: return {true, a - b, 0.0};
+            case ExprOp::Multiplicar: return {true, a * b, 0.0};
+            case ExprOp::Dividir:
+                if (b == 0) {
+                    std::cerr << "Error: DivisiÃ³n por cero" << std::endl;
+                    return {true, 0, 0.0};
+                }
+                return {true, a / b, 0.0};
+            case ExprOp::Modulo:
+                if (b == 0) {
+                    std::cerr << "Error: MÃ³dulo por cero" << std::endl;
+                    return {true, 0, 0.0};
+                }
+                return {true, a % b, 0.0};
+            default:
+                return {true, 0, 0.0};
+        }
     }
     
-    return result;
+    double a = left.asFloat();
+    double b = right.asFloat();
+    switch (op) {
+        case ExprOp::Sumar: return {false, 0, a + b};
+        case ExprOp::Restar: return {false, 0, a - b};
+        case ExprOp::Multiplicar: return {false, 0, a * b};
+        case ExprOp::Dividir:
+            if (b == 0.0) {
+                std::cerr << "Error: DivisiÃ³n por cero" << std::endl;
+                return {false, 0, 0.0};
+            }
+            return {false, 0, a / b};
+        case ExprOp::Modulo:
+            if (b == 0.0) {
+                std::cerr << "Error: MÃ³dulo por cero" << std::endl;
+                return {false, 0, 0.0};
+            }
+            return {false, 0, std::fmod(a, b)};
+        default:
+            return {false, 0, 0.0};
+    }
 }
 
-std::string ExpressionEvaluator::evaluateSinglePart(const std::string& part) {
-    std::string trimmed = Utils::trim(part);
+bool ExpressionEvaluator::compare(const ExprNode* node) {
+    const ExprNode* leftNode = node->children[0].get();
+    const ExprNode* rightNode = node->children[1].get();
     
-    // String literal
-    if (trimmed.length() >= 2 && trimmed.front() == '"' && trimmed.back() == '"') {
-        return trimmed.substr(1, trimmed.length() - 2);
+    // Las hojas se leen sin copiar; el resto se evalua una vez
+    Value leftHold, rightHold;
+    const Value* left = peek(leftNode);
+    if (!left) {
+        leftHold = evalValue(leftNode);
+        left = &leftHold;
+    }
+    const Value* right = peek(rightNode);
+    if (!right) {
+        rightHold = evalValue(rightNode);
+        right = &rightHold;
     }
     
-    // CRÃTICO: Primero buscar en variables string
-    auto stringIt = stringVariables.find(trimmed);
-    if (stringIt != stringVariables.end()) {
-        return stringIt->second;
+    if (left->getType() == ValueType::Texto && right->getType() == ValueType::Texto) {
+        int cmp = left->asText().compare(right->asText());
+        switch (node->op) {
+            case ExprOp::Igual: return cmp == 0;
+            case ExprOp::Distinto: return cmp != 0;
+            case ExprOp::Menor: return cmp < 0;
+            case ExprOp::Mayor: return cmp > 0;
+            case ExprOp::MenorIgual: return cmp <= 0;
+            case ExprOp::MayorIgual: return cmp >= 0;
+            default: return false;
+        }
     }
     
-    // CRÃTICO: Buscar en variables array y formatear correctamente
-    auto arrayIt = arrayVariables.find(trimmed);
-    if (arrayIt != arrayVariables.end()) {
-        const std::vector<std::string>& arr = arrayIt->second;
-        if (arr.empty()) return "";
-        
-        std::string result = "";
-        for (size_t i = 0; i < arr.size(); i++) {
-            if (i > 0) result += ", ";
-            result += arr[i]; // SIN COMILLAS EXTRA
+    Number a = toNumber(*left);
+    Number b = toNumber(*right);
+    if (a.isInt && b.isInt) {
+        switch (node->op) {
+            case ExprOp::Igual: return a.intValue == b.intValue;
+            case ExprOp::Distinto: return a.intValue != b.intValue;
+            case ExprOp::Menor: return a.intValue < b.intValue;
+            case ExprOp::Mayor: return a.intValue > b.intValue;
+            case ExprOp::MenorIgual: return a.intValue <= b.intValue;
+            case ExprOp::MayorIgual: return a.intValue >= b.intValue;
+            default: return false;
         }
-        return result;
     }
     
-    // Variables enteras
-    auto intIt = intVariables.find(trimmed);
-    if (intIt != intVariables.end()) {
-        return std::to_string(intIt->second);
+    double leftVal = a.asFloat();
+    double rightVal = b.asFloat();
+    switch (node->op) {
+        case ExprOp::Igual: return std::abs(leftVal - rightVal) < 0.0001;
+        case ExprOp::Distinto: return std::abs(leftVal - rightVal) >= 0.0001;
+        case ExprOp::Menor: return leftVal < rightVal;
+        case ExprOp::Mayor: return leftVal > rightVal;
+        case ExprOp::MenorIgual: return leftVal <= rightVal;
+        case ExprOp::MayorIgual: return leftVal >= rightVal;
+        default: return false;
     }
+}
+
+// Evalua los argumentos y salta a la funcion nativa resuelta al analizar
+Value ExpressionEvaluator::callFunction(const ExprNode* node) {
+    BuiltinArgs args;
+    Value hold[BuiltinArgs::Max];
     
-    // Variables float
-    auto floatIt = floatVariables.find(trimmed);
-    if (floatIt != floatVariables.end()) {
-        double val = floatIt->second;
-        if (val == (int)val) {
-            return std::to_string((int)val);
-        } else {
-            std::ostringstream oss;
-            oss.precision(2);
-            oss << std::fixed << val;
-            std::string str = oss.str();
-            while (str.length() > 1 && str.back() == '0' && str[str.length()-2] != '.') {
-                str.pop_back();
-            }
-            return str;
+    for (size_t i = 0; i < node->children.size(); i++) {
+        const ExprNode* child = node->children[i].get();
+        const Value* value = peek(child);
+        if (!value) {
+            hold[i] = evalValue(child);
+            value = &hold[i];
+        } else if (value->isEmpty() && child->kind == ExprKind::Variable) {
+            // Una palabra sin definir vale su propio nombre: tecla(izquierda)
+            hold[i] = Value::fromText(child->text);
+            value = &hold[i];
         }
+        args.values[i] = value;
     }
+    args.count = node->children.size();
     
-    // NÃºmero directo
-    try {
-        int intVal = std::stoi(trimmed);
-        return std::to_string(intVal);
-    } catch (...) {}
+    return node->builtin->callback(*this, args);
+}
+
+bool ExpressionEvaluator::isKeyPressed(const std::string& keyName) const {
+    int vkCode = Utils::getVirtualKeyCode(keyName);
+    if (vkCode == -1) return false;
     
-    try {
-        double doubleVal = std::stod(trimmed);
-        if (doubleVal == (int)doubleVal) {
-            return std::to_string((int)doubleVal);
-        } else {
-            std::ostringstream oss;
-            oss.precision(2);
-            oss << std::fixed << doubleVal;
-            std::string str = oss.str();
-            while (str.length() > 1 && str.back() == '0' && str[str.length()-2] != '.') {
-                str.pop_back();
-            }
-            return str;
+    for (const auto& win : windows) {
+        if (win.isGameWindow && win.keysPressed[vkCode]) {
+            return true;
         }
-    } catch (...) {}
-    
-    return trimmed;
+    }
+    return false;
 }
 
-double ExpressionEvaluator::evaluateFloatExpression(const std::string& expr) {
-    std::string trimmed = Utils::trim(expr);
-    
-    auto floatIt = floatVariables.find(trimmed);
-    if (floatIt != floatVariables.end()) {
-        return floatIt->second;
+// Lee el operando como decimales: la lista directamente, convertida si es de enteros, o un numero suelto
+static const double* floatData(const Value& value, double& scalar, std::vector<double>& converted) {
+    if (value.getType() != ValueType::Lista) {
+        scalar = value.toFloat();
+        return &scalar;
     }
-    
-    auto intIt = intVariables.find(trimmed);
-    if (intIt != intVariables.end()) {
-        return static_cast<double>(intIt->second);
+    if (value.listKind() == ListKind::Decimal) {
+        return value.listFloats();
+    }
+    converted.assign(value.listInts(), value.listInts() + value.listSize());
+    return converted.data();
+}
+
+Value ExpressionEvaluator::elementwise(KernelOp op, const Value& left, const Value& right) {
+    // El analisis solo supone que habra una lista numerica; si al final no hay
+    // ninguna se opera con los dos numeros sueltos
+    bool leftList = left.isNumericList();
+    bool rightList = right.isNumericList();
+    bool scalar = !leftList && !rightList;
+    size_t count = leftList ? left.listSize() : rightList ? right.listSize() : 1;
+    if (leftList && rightList && left.listSize() != right.listSize()) {
+        std::cerr << "Error: Las listas tienen distinto largo (" << left.listSize() << " y "
+                  << right.listSize() << ")" << std::endl;
+        count = std::min(left.listSize(), right.listSize());
     }
     
-    try {
-        return std::stod(trimmed);
-    } catch (...) {}
+    bool leftInt = leftList ? left.listKind() == ListKind::Entero : left.getType() != ValueType::Decimal;
+    bool rightInt = rightList ? right.listKind() == ListKind::Entero : right.getType() != ValueType::Decimal;
+    bool ok;
     
-    std::vector<std::string> ops = {"+", "-", "*", "/"};
-    for (const std::string& op : ops) {
-        std::string opPattern = " " + op + " ";
-        size_t pos = trimmed.find(opPattern);
-        if (pos != std::string::npos) {
-            std::string left = Utils::trim(trimmed.substr(0, pos));
-            std::string right = Utils::trim(trimmed.substr(pos + opPattern.length()));
-            
-            double leftVal = evaluateFloatExpression(left);
-            double rightVal = evaluateFloatExpression(right);
-            
-            if (op == "+") return leftVal + rightVal;
-            if (op == "-") return leftVal - rightVal;
-            if (op == "*") return leftVal * rightVal;
-            if (op == "/") {
-                if (rightVal != 0.0) {
-                    return leftVal / rightVal;
-                } else {
-                    std::cerr << "Error: DivisiÃ³n por cero" << std::endl;
-                    return 0.0;
-                }
-            }
-        }
+    // Enteros con enteros siguen siendo enteros; si hay algun decimal todo pasa a decimal
+    if (leftInt && rightInt) {
+        long long leftScalar = left.toInt();
+        long long rightScalar = right.toInt();
+        const long long* a = leftList ? left.listInts() : &leftScalar;
+        const long long* b = rightList ? right.listInts() : &rightScalar;
+        std::vector<long long> out(count);
+        ok = NumericKernels::applyInt(op, a, leftList ? 1 : 0, b, rightList ? 1 : 0, out.data(), count);
+        if (!ok) std::cerr << "Error: DivisiÃ³n por cero" << std::endl;
+        if (scalar) return Value::fromInt(out[0]);
+        return Value::fromIntList(std::move(out));
     }
     
-    return 0.0;
+    double leftScalar, rightScalar;
+    std::vector<double> leftConverted, rightConverted;
+    const double* a = floatData(left, leftScalar, leftConverted);
+    const double* b = floatData(right, rightScalar, rightConverted);
+    std::vector<double> out(count);
+    ok = NumericKernels::applyFloat(op, a, leftList ? 1 : 0, b, rightList ? 1 : 0, out.data(), count);
+    if (!ok) std::cerr << "Error: DivisiÃ³n por cero" << std::endl;
+    if (scalar) return Value::fromFloat(out[0]);
+    return Value::fromFloatList(std::move(out));
 }
 
-int ExpressionEvaluator::evaluateIntExpression(const std::string& expr) {
-    std::string trimmed = Utils::trim(expr);
+// Posicion dentro de una lista o texto; las negativas cuentan desde el final
+size_t ExpressionEvaluator::readPosition(const ExprNode* node, size_t size, size_t omitted) {
+    if (node->kind == ExprKind::Constante && node->constant.isEmpty()) {
+        return omitted;
+    }
+    long long position = evalNumber(node).asInt();
+    if (position < 0) {
+        position += static_cast<long long>(size);
+        if (position < 0) position = 0;
+    }
+    return static_cast<size_t>(position);
+}
+
+// lista[i] y lista[a:b]; la rebanada comparte los elementos de la lista original
+Value ExpressionEvaluator::evalIndex(const ExprNode* node) {
+    const ExprNode* targetNode = node->children[0].get();
+    Value hold;
+    const Value* target = peek(targetNode);
+    if (!target) {
+        hold = evalValue(targetNode);
+        target = &hold;
+    }
     
-    if (trimmed.find("aleatorio(") == 0) {
-        size_t start = trimmed.find('(') + 1;
-        size_t end = trimmed.find_last_of(')');
-        if (start < end) {
-            std::string params = trimmed.substr(start, end - start);
-            size_t commaPos = params.find(',');
-            if (commaPos != std::string::npos) {
-                int min = evaluateIntExpression(Utils::trim(params.substr(0, commaPos)));
-                int max = evaluateIntExpression(Utils::trim(params.substr(commaPos + 1)));
-                
-                static std::random_device rd;
-                static std::mt19937 gen(rd());
-                std::uniform_int_distribution<> dis(min, max);
-                return dis(gen);
-            }
+    if (target->getType() == ValueType::Diccionario && node->kind == ExprKind::Indice) {
+        std::string key = textOf(node->children[1].get());
+        const Value* item = target->asDictionary().find(key);
+        if (!item) {
+            std::cerr << "Error: Clave '" << key << "' no encontrada" << std::endl;
+            return Value();
         }
-        return 0;
+        return *item;
     }
     
-    auto intIt = intVariables.find(trimmed);
-    if (intIt != intVariables.end()) {
-        return intIt->second;
+    bool isList = target->getType() == ValueType::Lista;
+    if (!isList && target->getType() != ValueType::Texto) {
+        std::cerr << "Error: Solo se pueden indexar listas, textos y diccionarios" << std::endl;
+        return Value();
     }
+    size_t size = isList ? target->listSize() : target->asText().length();
     
-    auto floatIt = floatVariables.find(trimmed);
-    if (floatIt != floatVariables.end()) {
-        return static_cast<int>(floatIt->second);
+    if (node->kind == ExprKind::Rebanada) {
+        size_t start = readPosition(node->children[1].get(), size, 0);
+        size_t end = readPosition(node->children[2].get(), size, size);
+        if (isList) return target->listSlice(start, end);
+        end = std::min(end, size);
+        start = std::min(start, end);
+        return Value::fromText(std::string(target->asText().substr(start, end - start)));
     }
     
-    try {
-        return std::stoi(trimmed);
-    } catch (...) {}
-    
-    std::vector<std::string> ops = {"+", "-", "*", "/", "%"};
-    for (const std::string& op : ops) {
-        std::string opPattern = " " + op + " ";
-        size_t pos = trimmed.find(opPattern);
-        if (pos != std::string::npos) {
-            std::string left = Utils::trim(trimmed.substr(0, pos));
-            std::string right = Utils::trim(trimmed.substr(pos + opPattern.length()));
-            
-            int leftVal = evaluateIntExpression(left);
-            int rightVal = evaluateIntExpression(right);
-            
-            if (op == "+") return leftVal + rightVal;
-            if (op == "-") return leftVal - rightVal;
-            if (op == "*") return leftVal * rightVal;
-            if (op == "/") {
-                if (rightVal != 0) {
-                    return leftVal / rightVal;
-                } else {
-                    std::cerr << "Error: DivisiÃ³n por cero" << std::endl;
-                    return 0;
-                }
+    long long index = evalNumber(node->children[1].get()).asInt();
+    long long position = index < 0 ? index + static_cast<long long>(size) : index;
+    if (position < 0 || position >= static_cast<long long>(size)) {
+        std::cerr << "Error: Indice " << index << " fuera de rango (largo " << size << ")" << std::endl;
+        return Value();
+    }
+    if (isList) return target->listItem(position);
+    return Value::fromText(std::string(1, target->asText()[position]));
+}
+
+ExpressionEvaluator::Number ExpressionEvaluator::evalNumber(const ExprNode* node) {
+    switch (node->kind) {
+        case ExprKind::Constante:
+            return toNumber(node->constant);
+        case ExprKind::Variable:
+            return toNumber(symbols.at(node->slot));
+        case ExprKind::Negativo: {
+            Number n = evalNumber(node->children[0].get());
+            return n.isInt ? Number{true, -n.intValue, 0.0} : Number{false, 0, -n.floatValue};
+        }
+        case ExprKind::Binaria:
+            if (node->op >= ExprOp::Igual) {
+                return {true, compare(node) ? 1 : 0, 0.0};
             }
-            if (op == "%") {
-                if (rightVal != 0) {
-                    return leftVal % rightVal;
-                } else {
-                    std::cerr << "Error: MÃ³dulo por cero" << std::endl;
-                    return 0;
-                }
+            return arithmetic(node->op, evalNumber(node->children[0].get()), evalNumber(node->children[1].get()));
+        case ExprKind::Llamada:
+            return toNumber(callFunction(node));
+        case ExprKind::Indice:
+            return toNumber(evalIndex(node));
+        default:
+            return {true, 0, 0.0};
+    }
+}
+
+Value ExpressionEvaluator::evalValue(const ExprNode* node) {
+    switch (node->kind) {
+        case ExprKind::Constante:
+            return node->constant;
+        case ExprKind::Variable:
+            return symbols.at(node->slot);
+        case ExprKind::Binaria:
+            if (producesNumericList(node)) {
+                return elementwise(toKernelOp(node->op), evalValue(node->children[0].get()),
+                                   evalValue(node->children[1].get()));
             }
+            if (!producesText(node)) break;
+            return Value::fromText(textOf(node));
+        case ExprKind::Concatenar:
+            return Value::fromText(textOf(node));
+        case ExprKind::Llamada:
+            return callFunction(node);
+        case ExprKind::Indice:
+        case ExprKind::Rebanada:
+            return evalIndex(node);
+        case ExprKind::Diccionario: {
+            Value dict = Value::newDictionary();
+            Dictionary& entries = dict.mutableDictionary();
+            for (size_t i = 0; i + 1 < node->children.size(); i += 2) {
+                entries.set(textOf(node->children[i].get()), evalValue(node->children[i + 1].get()));
+            }
+            return dict;
         }
+        case ExprKind::Crudo:
+            return Value::fromText(node->text);
+        default:
+            break;
+    }
+    
+    Number n = evalNumber(node);
+    return n.isInt ? Value::fromInt(n.intValue) : Value::fromFloat(n.floatValue);
+}
+
+Value ExpressionEvaluator::evaluate(const ExprNode* expr) {
+    Value result = evalValue(expr);
+    if (result.isEmpty()) {
+        return Value::fromInt(0);
+    }
+    return result;
+}
+
+std::string ExpressionEvaluator::evaluateStringExpression(const ExprNode* expr) {
+    return textOf(expr);
+}
+
+// Valor con su tipo; lo que no tiene valor (una palabra sin definir) queda como su texto
+Value ExpressionEvaluator::evaluateTyped(const ExprNode* expr) {
+    Value result = evalValue(expr);
+    if (result.isEmpty()) {
+        return Value::fromText(textOf(expr));
     }
+    return result;
+}
+
+double ExpressionEvaluator::evaluateFloatExpression(const ExprNode* expr) {
+    return evalNumber(expr).asFloat();
+}
+
+long long ExpressionEvaluator::evaluateIntExpression(const ExprNode* expr) {
+    return evalNumber(expr).asInt();
+}
+
+// Valor de texto de la expresion como simbolo internado (titulos, nombres de objetos)
+int ExpressionEvaluator::evaluateSymbol(const ExprNode* node) {
+    if (node->kind == ExprKind::Constante && node->symbol >= 0) {
+        return node->symbol;
+    }
+    if (node->kind == ExprKind::Variable && symbols.at(node->slot).isEmpty()) {
+        return node->symbol;
+    }
+    return StringTable::intern(textOf(node));
+}
+
+// ingrediente r = r + ...: anade al final del texto de r en lugar de copiarlo entero
+bool ExpressionEvaluator::appendInPlace(int slot, const ExprNode* node) {
+    const ExprNode* first = firstTextPart(node);
+    
+    if (first == node || first->kind != ExprKind::Variable || first->slot != slot) return false;
+    if (symbols.at(slot).getType() != ValueType::Texto) return false;
+    if (readsSlot(node, slot, first)) return false;
     
-    return 0;
+    std::string& text = symbols.modify(slot).mutableText();
+    text.reserve(text.length() + measureRest(node, first));
+    appendRest(node, first, text);
+    return true;
 }
 
-bool ExpressionEvaluator::evaluateCondition(const std::string& condition) {
-    std::string trimmed = Utils::trim(condition);
+// Claves de un diccionario como lista de textos, en orden de insercion
+Value ExpressionEvaluator::keysOf(const Value& dict) {
+    std::vector<std::string> keys = dict.asDictionary().keys();
+    for (std::string& key : keys) {
+        key = "\"" + key + "\"";
+    }
+    return Value::fromList(std::move(keys));
+}
+
+// Posicion de lista[i] para cambiarla o quitarla; -1 si no es valida
+long long ExpressionEvaluator::listPosition(int slot, const ExprNode* indexExpr) {
+    long long index = evaluateIntExpression(indexExpr);
+    long long size = static_cast<long long>(symbols.at(slot).listSize());
+    long long position = index < 0 ? index + size : index;
+    if (position < 0 || position >= size) {
+        std::cerr << "Error: Indice " << index << " fuera de rango (largo " << size << ")" << std::endl;
+        return -1;
+    }
+    return position;
+}
+
+// ingrediente lista[i] = valor o dic[clave] = valor: solo se copia si otra variable lo comparte
+void ExpressionEvaluator::assignItem(int slot, const ExprNode* indexExpr, const ExprNode* expr) {
+    Value item = evaluate(expr);
+    ValueType type = symbols.at(slot).getType();
     
-    if (trimmed.find("tecla(") == 0) {
-        size_t start = trimmed.find('(') + 1;
-        size_t end = trimmed.find_last_of(')');
-        if (start < end) {
-            std::string keyName = Utils::trim(trimmed.substr(start, end - start));
-            keyName = evaluateStringExpression(keyName);
-            
-            int vkCode = Utils::getVirtualKeyCode(keyName);
-            if (vkCode != -1) {
-                for (const auto& win : windows) {
-                    if (win.isGameWindow && win.keysPressed[vkCode]) {
-                        return true;
-                    }
-                }
-            }
-        }
-        return false;
+    if (type == ValueType::Diccionario) {
+        std::string key = evaluateStringExpression(indexExpr);
+        symbols.modify(slot).mutableDictionary().set(key, std::move(item));
+        return;
+    }
+    if (type != ValueType::Lista) {
+        std::cerr << "Error: '" << symbols.nameOf(slot) << "' no es una lista ni un diccionario" << std::endl;
+        return;
+    }
+    long long position = listPosition(slot, indexExpr);
+    if (position >= 0) {
+        symbols.modify(slot).setListItem(static_cast<size_t>(position), item);
     }
+}
+
+// quitar lista[i] o quitar dic[clave]
+void ExpressionEvaluator::removeItem(int slot, const ExprNode* indexExpr) {
+    ValueType type = symbols.at(slot).getType();
     
-    std::vector<std::string> compOps = {"==", "!=", "<=", ">=", "<", ">"};
-    for (const std::string& op : compOps) {
-        size_t pos = trimmed.find(" " + op + " ");
-        if (pos != std::string::npos) {
-            std::string left = Utils::trim(trimmed.substr(0, pos));
-            std::string right = Utils::trim(trimmed.substr(pos + op.length() + 2));
-            
-            double leftVal = evaluateFloatExpression(left);
-            double rightVal = evaluateFloatExpression(right);
-            
-            if (op == "==") return std::abs(leftVal - rightVal) < 0.0001;
-            if (op == "!=") return std::abs(leftVal - rightVal) >= 0.0001;
-            if (op == "<=") return leftVal <= rightVal;
-            if (op == ">=") return leftVal >= rightVal;
-            if (op == "<") return leftVal < rightVal;
-            if (op == ">") return leftVal > rightVal;
+    if (type == ValueType::Diccionario) {
+        std::string key = evaluateStringExpression(indexExpr);
+        if (!symbols.at(slot).asDictionary().find(key)) {
+            std::cerr << "Error: Clave '" << key << "' no encontrada" << std::endl;
+            return;
         }
+        symbols.modify(slot).mutableDictionary().erase(key);
+        return;
+    }
+    if (type != ValueType::Lista) {
+        std::cerr << "Error: '" << symbols.nameOf(slot) << "' no es una lista ni un diccionario" << std::endl;
+        return;
+    }
+    long long position = listPosition(slot, indexExpr);
+    if (position >= 0) {
+        symbols.modify(slot).removeListItem(static_cast<size_t>(position));
+    }
+}
+
+bool ExpressionEvaluator::evaluateCondition(const ExprNode* node) {
+    if (node->kind == ExprKind::Binaria && node->op >= ExprOp::Igual) {
+        return compare(node);
     }
     
-    return false;
-}
\ No newline at end of file
+    Number n = evalNumber(node);
+    return n.isInt ? n.intValue != 0 : n.floatValue != 0.0;
+}
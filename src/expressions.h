@@ -2,29 +2,75 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include "structures.h"
+#include "symbol_table.h"
+#include "expression_parser.h"
+#include "numeric_kernels.h"
+#include "random_generator.h"
 
 class ExpressionEvaluator {
 private:
-    std::map<std::string, int>& intVariables;
-    std::map<std::string, std::string>& stringVariables;
-    std::map<std::string, double>& floatVariables;
-    std::map<std::string, std::vector<std::string>>& arrayVariables;
+    // Resultado numerico sin reservar memoria: entero o decimal
+    struct Number {
+        bool isInt;
+        long long intValue;
+        double floatValue;
+        
+        double asFloat() const { return isInt ? static_cast<double>(intValue) : floatValue; }
+        long long asInt() const { return isInt ? intValue : static_cast<long long>(floatValue); }
+    };
+    
+    SymbolTable& symbols;
     std::vector<WindowInfo>& windows;
-
-    std::string evaluateSinglePart(const std::string& part);
+    RandomGenerator random;
+    
+    // Cada texto de expresion se analiza una sola vez; los comandos guardan el arbol
+    // y solo pasan por aqui la primera vez
+    std::unordered_map<std::string, std::unique_ptr<ExprNode>> cache;
+    
+    const ExprNode* getExpression(const std::string& expr);
+    const Value* peek(const ExprNode* node) const;
+    std::string textOf(const ExprNode* node);
+    bool producesText(const ExprNode* node) const;
+    bool producesNumericList(const ExprNode* node) const;
+    size_t measureText(const ExprNode* node) const;
+    void appendText(const ExprNode* node, std::string& out);
+    const ExprNode* firstTextPart(const ExprNode* node) const;
+    bool readsSlot(const ExprNode* node, int slot, const ExprNode* skip) const;
+    size_t measureRest(const ExprNode* node, const ExprNode* first) const;
+    void appendRest(const ExprNode* node, const ExprNode* first, std::string& out);
+    
+    Value evalValue(const ExprNode* node);
+    Number evalNumber(const ExprNode* node);
+    Number arithmetic(ExprOp op, const Number& left, const Number& right);
+    bool compare(const ExprNode* node);
+    Value callFunction(const ExprNode* node);
+    Value evalIndex(const ExprNode* node);
+    size_t readPosition(const ExprNode* node, size_t size, size_t omitted);
+    long long listPosition(int slot, const ExprNode* indexExpr);
+    
+    static Number toNumber(const Value& value);
 
 public:
-    ExpressionEvaluator(
-        std::map<std::string, int>& intVars,
-        std::map<std::string, std::string>& stringVars,
-        std::map<std::string, double>& floatVars,
-        std::map<std::string, std::vector<std::string>>& arrayVars,
-        std::vector<WindowInfo>& windows
-    );
+    ExpressionEvaluator(SymbolTable& symbols, std::vector<WindowInfo>& windows);
 
-    std::string evaluateStringExpression(const std::string& expr);
-    double evaluateFloatExpression(const std::string& expr);
-    int evaluateIntExpression(const std::string& expr);
-    bool evaluateCondition(const std::string& condition);
+    const ExprNode* expression(const std::string& expr, const ExprNode*& tree);
+    
+    Value evaluate(const ExprNode* expr);
+    std::string evaluateStringExpression(const ExprNode* expr);
+    Value evaluateTyped(const ExprNode* expr);
+    double evaluateFloatExpression(const ExprNode* expr);
+    long long evaluateIntExpression(const ExprNode* expr);
+    int evaluateSymbol(const ExprNode* expr);
+    bool appendInPlace(int slot, const ExprNode* expr);
+    void assignItem(int slot, const ExprNode* indexExpr, const ExprNode* expr);
+    void removeItem(int slot, const ExprNode* indexExpr);
+    bool isKeyPressed(const std::string& keyName) const;
+    RandomGenerator& randomGenerator() { return random; }
+    
+    static Value keysOf(const Value& dict);
+    static Value elementwise(KernelOp op, const Value& left, const Value& right);
+    bool evaluateCondition(const ExprNode* condition);
 };
@@ -1,4 +1,6 @@
 #include "interpreter.h"
+#include "parser.h"
+#include "vm.h"
 #include <iostream>
 #include <fstream>
 
@@ -10,7 +12,7 @@ PancracioInterpreter::~PancracioInterpreter() {
     delete executor;
 }
 
-void PancracioInterpreter::executeFile(const std::string& filename) {
+void PancracioInterpreter::executeFile(const std::string& filename, bool useVm) {
     std::ifstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
@@ -24,8 +26,14 @@ void PancracioInterpreter::executeFile(const std::string& filename) {
     }
     file.close();
     
-    for (int i = 0; i < static_cast<int>(lines.size()); i++) {
-        executor->executeLine(lines, i);
+    Parser parser(executor->getSymbols());
+    std::shared_ptr<const std::vector<Command>> program = parser.parse(lines);
+    
+    if (useVm) {
+        VirtualMachine vm(*executor);
+        vm.execute(program);
+    } else {
+        executor->executeProgram(program);
     }
     
     if (executor->hasWindows()) {
@@ -72,4 +80,5 @@ void PancracioInterpreter::showVersion() {
     std::cout << "Teclas soportadas: arriba, abajo, izquierda, derecha, espacio, a, s, d, w" << std::endl;
     std::cout << std::endl;
     std::cout << "Uso: pan archivo.pan" << std::endl;
+    std::cout << "     pan --vm archivo.pan (ejecutar con la maquina virtual de bytecode)" << std::endl;
 }
\ No newline at end of file
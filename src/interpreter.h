@@ -11,6 +11,6 @@ public:
     PancracioInterpreter();
     ~PancracioInterpreter();
     
-    void executeFile(const std::string& filename);
+    void executeFile(const std::string& filename, bool useVm = false);
     void showVersion();
 };
\ No newline at end of file
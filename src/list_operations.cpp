@@ -0,0 +1,260 @@
+#include "list_operations.h"
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+// Por debajo de este largo repartir el trabajo entre hilos cuesta mas de lo que ahorra
+static const size_t ParallelSortMin = 100000;
+
+// Buscar menos veces en listas cortas es mas rapido recorriendolas que creando el indice
+static const size_t IndexMin = 32;
+
+// Hilos que se crean la primera vez que se ordena y se reutilizan en cada ordenar
+class WorkerPool {
+public:
+    static WorkerPool& instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+    
+    // Hilos que trabajan en run, contando el que llama
+    size_t size() const { return workers.size() + 1; }
+    
+    // Reparte las tareas entre los hilos y el que llama; vuelve cuando terminan todas
+    void run(std::vector<std::function<void()>>& work) {
+        std::lock_guard<std::mutex> running(runMutex);
+        std::unique_lock<std::mutex> lock(mutex);
+        tasks = &work;
+        next = 0;
+        pending = work.size();
+        wake.notify_all();
+        
+        while (next < work.size()) {
+            size_t task = next++;
+            lock.unlock();
+            work[task]();
+            lock.lock();
+            pending--;
+        }
+        done.wait(lock, [this] { return pending == 0; });
+        tasks = nullptr;
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::vector<std::function<void()>>* tasks = nullptr;
+    size_t next = 0;
+    size_t pending = 0;
+    bool stopping = false;
+    
+    WorkerPool() {
+        size_t count = std::min<size_t>(std::thread::hardware_concurrency(), 8);
+        for (size_t i = 1; i < count; i++) {
+            workers.emplace_back([this] { work(); });
+        }
+    }
+    
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+    
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopping || (tasks && next < tasks->size()); });
+            if (stopping) return;
+            
+            size_t task = next++;
+            std::function<void()>& job = (*tasks)[task];
+            lock.unlock();
+            job();
+            lock.lock();
+            if (--pending == 0) done.notify_all();
+        }
+    }
+};
+
+// Ordena por tramos en los hilos del pool y luego mezcla los tramos de dos en dos
+template <typename T, typename Less>
+static void parallelSort(std::vector<T>& data, Less less) {
+    if (data.size() < ParallelSortMin || std::thread::hardware_concurrency() < 2) {
+        std::sort(data.begin(), data.end(), less);
+        return;
+    }
+    
+    WorkerPool& pool = WorkerPool::instance();
+    size_t parts = pool.size();
+    std::vector<size_t> bounds;
+    for (size_t i = 0; i <= parts; i++) {
+        bounds.push_back(data.size() * i / parts);
+    }
+    
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < parts; i++) {
+        tasks.push_back([&data, &bounds, &less, i] {
+            std::sort(data.begin() + bounds[i], data.begin() + bounds[i + 1], less);
+        });
+    }
+    pool.run(tasks);
+    
+    for (size_t width = 1; width < parts; width *= 2) {
+        tasks.clear();
+        for (size_t i = 0; i + width < parts; i += 2 * width) {
+            size_t end = std::min(i + 2 * width, parts);
+            tasks.push_back([&data, &bounds, &less, i, width, end] {
+                std::inplace_merge(data.begin() + bounds[i], data.begin() + bounds[i + width],
+                                   data.begin() + bounds[end], less);
+            });
+        }
+        pool.run(tasks);
+    }
+}
+
+// Orden de los elementos de una lista de textos: primero los numeros, luego los textos
+static bool itemLess(const Value& a, const Value& b) {
+    if (a.isNumeric() != b.isNumeric()) return a.isNumeric();
+    if (a.isNumeric()) return a.toFloat() < b.toFloat();
+    return a.asText() < b.asText();
+}
+
+Value ListOperations::sort(const Value& list, bool descending) {
+    size_t count = list.listSize();
+    
+    switch (list.listKind()) {
+        case ListKind::Entero: {
+            std::vector<long long> items(list.listInts(), list.listInts() + count);
+            if (descending) parallelSort(items, std::greater<long long>());
+            else parallelSort(items, std::less<long long>());
+            return Value::fromIntList(std::move(items));
+        }
+        case ListKind::Decimal: {
+            std::vector<double> items(list.listFloats(), list.listFloats() + count);
+            if (descending) parallelSort(items, std::greater<double>());
+            else parallelSort(items, std::less<double>());
+            return Value::fromFloatList(std::move(items));
+        }
+        default:
+            break;
+    }
+    
+    // Se ordenan posiciones con los valores ya leidos y se copian los textos al final
+    std::vector<Value> items;
+    items.reserve(count);
+    std::vector<size_t> order;
+    order.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        items.push_back(list.listItem(i));
+        order.push_back(i);
+    }
+    if (descending) {
+        parallelSort(order, [&items](size_t a, size_t b) { return itemLess(items[b], items[a]); });
+    } else {
+        parallelSort(order, [&items](size_t a, size_t b) { return itemLess(items[a], items[b]); });
+    }
+    
+    std::vector<std::string> texts;
+    texts.reserve(count);
+    for (size_t position : order) {
+        texts.push_back(list.listText(position));
+    }
+    return Value::fromList(std::move(texts));
+}
+
+Value ListOperations::unique(const Value& list) {
+    size_t count = list.listSize();
+    
+    switch (list.listKind()) {
+        case ListKind::Entero: {
+            std::unordered_set<long long> seen;
+            std::vector<long long> items;
+            for (size_t i = 0; i < count; i++) {
+                if (seen.insert(list.listInts()[i]).second) items.push_back(list.listInts()[i]);
+            }
+            return Value::fromIntList(std::move(items));
+        }
+        case ListKind::Decimal: {
+            std::unordered_set<double> seen;
+            std::vector<double> items;
+            for (size_t i = 0; i < count; i++) {
+                if (seen.insert(list.listFloats()[i]).second) items.push_back(list.listFloats()[i]);
+            }
+            return Value::fromFloatList(std::move(items));
+        }
+        default: {
+            std::unordered_set<std::string> seen;
+            std::vector<std::string> texts;
+            for (size_t i = 0; i < count; i++) {
+                if (seen.insert(list.listItem(i).toString()).second) texts.push_back(list.listText(i));
+            }
+            return Value::fromList(std::move(texts));
+        }
+    }
+}
+
+// El indice cubre la lista entera; las rebanadas y las listas cortas se recorren
+long long ListOperations::find(const Value& list, const Value& item) {
+    size_t count = list.listSize();
+    ListKind kind = list.listKind();
+    
+    // Clave del elemento buscado en el tipo de la lista; un texto no esta en una lista de numeros
+    long long intKey = item.toInt();
+    double floatKey = item.toFloat();
+    std::string textKey = item.toString();
+    if (kind != ListKind::Texto && !item.isNumeric()) return -1;
+    if (kind == ListKind::Entero && static_cast<double>(intKey) != floatKey) return -1;
+    
+    if (!list.isWholeList() || count < IndexMin) {
+        for (size_t i = 0; i < count; i++) {
+            switch (kind) {
+                case ListKind::Entero: if (list.listInts()[i] == intKey) return i; break;
+                case ListKind::Decimal: if (list.listFloats()[i] == floatKey) return i; break;
+                default: if (list.listItem(i).toString() == textKey) return i; break;
+            }
+        }
+        return -1;
+    }
+    
+    const ListData& data = list.listData();
+    if (!data.index) {
+        data.index = std::make_unique<ListIndex>();
+        switch (kind) {
+            case ListKind::Entero: data.index->ints.reserve(count); break;
+            case ListKind::Decimal: data.index->floats.reserve(count); break;
+            default: data.index->texts.reserve(count); break;
+        }
+        for (size_t i = count; i-- > 0;) {
+            switch (kind) {
+                case ListKind::Entero: data.index->ints[data.ints[i]] = i; break;
+                case ListKind::Decimal: data.index->floats[data.floats[i]] = i; break;
+                default: data.index->texts[list.listItem(i).toString()] = i; break;
+            }
+        }
+    }
+    
+    switch (kind) {
+        case ListKind::Entero: {
+            auto it = data.index->ints.find(intKey);
+            return it == data.index->ints.end() ? -1 : static_cast<long long>(it->second);
+        }
+        case ListKind::Decimal: {
+            auto it = data.index->floats.find(floatKey);
+            return it == data.index->floats.end() ? -1 : static_cast<long long>(it->second);
+        }
+        default: {
+            auto it = data.index->texts.find(textKey);
+            return it == data.index->texts.end() ? -1 : static_cast<long long>(it->second);
+        }
+    }
+}
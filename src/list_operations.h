@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include "value.h"
+
+// Operaciones de lista para los scripts: ordenar, buscar y quitar repetidos.
+// Devuelven listas nuevas; la original no cambia.
+class ListOperations {
+public:
+    static Value sort(const Value& list, bool descending);
+    static Value unique(const Value& list);
+    
+    // Posicion de la primera aparicion de item, o -1 si no esta
+    static long long find(const Value& list, const Value& item);
+};
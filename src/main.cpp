@@ -17,6 +17,7 @@
 #pragma comment(lib, "user32.lib")
 
 #include "interpreter.h"
+#include "book_manager.h"
 
 int main(int argc, char* argv[]) {
 #ifdef _WIN32
@@ -47,21 +48,33 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
-    if (argc != 2) {
+    // Conversion de libros .pansos entre texto y binario
+    if ((argc == 3 || argc == 4) && (std::string(argv[1]) == "--a-binario" || std::string(argv[1]) == "--a-texto")) {
+        BookManager book;
+        std::string target = argv[argc - 1];
+        return book.convertFile(argv[2], target, std::string(argv[1]) == "--a-binario") ? 0 : 1;
+    }
+    
+    bool useVm = argc == 3 && std::string(argv[1]) == "--vm";
+    
+    if (argc != 2 && !useVm) {
         std::cerr << "Uso: pan archivo.pan" << std::endl;
+        std::cerr << "  o: pan --vm archivo.pan (maquina virtual de bytecode)" << std::endl;
+        std::cerr << "  o: pan --a-binario libro.pansos [destino.pansos] (libro a formato binario)" << std::endl;
+        std::cerr << "  o: pan --a-texto libro.pansos [destino.pansos] (libro a formato de texto)" << std::endl;
         std::cerr << "  o: pan --uninstall (para desinstalar)" << std::endl;
         std::cerr << "  o: pan --version (mostrar version)" << std::endl;
         return 1;
     }
     
-    std::string filename = argv[1];
+    std::string filename = argv[useVm ? 2 : 1];
     if (filename.length() < 4 || filename.substr(filename.length() - 4) != ".pan") {
         std::cerr << "Error: El archivo debe tener extension .pan" << std::endl;
         return 1;
     }
     
     PancracioInterpreter interpreter;
-    interpreter.executeFile(filename);
+    interpreter.executeFile(filename, useVm);
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include "numeric_kernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+long long NumericKernels::sumInt(const long long* data, size_t count) {
+    size_t i = 0;
+    long long total = 0;
+#if defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 4 <= count; i += 4) {
+        acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    }
+    alignas(32) long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__SSE2__)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 2 <= count; i += 2) {
+        acc = _mm_add_epi64(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+    }
+    alignas(16) long long lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < count; i++) {
+        total += data[i];
+    }
+    return total;
+}
+
+double NumericKernels::sumFloat(const double* data, size_t count) {
+    size_t i = 0;
+    double total = 0.0;
+#if defined(__AVX2__)
+    // Dos acumuladores para no esperar a la suma anterior en cada vuelta
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(data + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(data + i + 4));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(acc0, acc1));
+    total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(__SSE2__)
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(data + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(data + i + 2));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, _mm_add_pd(acc0, acc1));
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < count; i++) {
+        total += data[i];
+    }
+    return total;
+}
+
+// Comparar enteros de 64 bits en paralelo necesita AVX2; con SSE2 va en escalar
+long long NumericKernels::minInt(const long long* data, size_t count) {
+    size_t i = 0;
+    long long result = count > 0 ? data[0] : 0;
+#if defined(__AVX2__)
+    if (count >= 4) {
+        __m256i best = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        for (i = 4; i + 4 <= count; i += 4) {
+            __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            best = _mm256_blendv_epi8(best, values, _mm256_cmpgt_epi64(best, values));
+        }
+        alignas(32) long long lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), best);
+        result = lanes[0];
+        for (int lane = 1; lane < 4; lane++) {
+            if (lanes[lane] < result) result = lanes[lane];
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        if (data[i] < result) result = data[i];
+    }
+    return result;
+}
+
+long long NumericKernels::maxInt(const long long* data, size_t count) {
+    size_t i = 0;
+    long long result = count > 0 ? data[0] : 0;
+#if defined(__AVX2__)
+    if (count >= 4) {
+        __m256i best = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        for (i = 4; i + 4 <= count; i += 4) {
+            __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            best = _mm256_blendv_epi8(best, values, _mm256_cmpgt_epi64(values, best));
+        }
+        alignas(32) long long lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), best);
+        result = lanes[0];
+        for (int lane = 1; lane < 4; lane++) {
+            if (lanes[lane] > result) result = lanes[lane];
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        if (data[i] > result) result = data[i];
+    }
+    return result;
+}
+
+double NumericKernels::minFloat(const double* data, size_t count) {
+    size_t i = 0;
+    double result = count > 0 ? data[0] : 0.0;
+#if defined(__AVX2__)
+    if (count >= 4) {
+        __m256d best = _mm256_loadu_pd(data);
+        for (i = 4; i + 4 <= count; i += 4) {
+            best = _mm256_min_pd(best, _mm256_loadu_pd(data + i));
+        }
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, best);
+        result = lanes[0];
+        for (int lane = 1; lane < 4; lane++) {
+            if (lanes[lane] < result) result = lanes[lane];
+        }
+    }
+#elif defined(__SSE2__)
+    if (count >= 2) {
+        __m128d best = _mm_loadu_pd(data);
+        for (i = 2; i + 2 <= count; i += 2) {
+            best = _mm_min_pd(best, _mm_loadu_pd(data + i));
+        }
+        alignas(16) double lanes[2];
+        _mm_store_pd(lanes, best);
+        result = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    }
+#endif
+    for (; i < count; i++) {
+        if (data[i] < result) result = data[i];
+    }
+    return result;
+}
+
+double NumericKernels::maxFloat(const double* data, size_t count) {
+    size_t i = 0;
+    double result = count > 0 ? data[0] : 0.0;
+#if defined(__AVX2__)
+    if (count >= 4) {
+        __m256d best = _mm256_loadu_pd(data);
+        for (i = 4; i + 4 <= count; i += 4) {
+            best = _mm256_max_pd(best, _mm256_loadu_pd(data + i));
+        }
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, best);
+        result = lanes[0];
+        for (int lane = 1; lane < 4; lane++) {
+            if (lanes[lane] > result) result = lanes[lane];
+        }
+    }
+#elif defined(__SSE2__)
+    if (count >= 2) {
+        __m128d best = _mm_loadu_pd(data);
+        for (i = 2; i + 2 <= count; i += 2) {
+            best = _mm_max_pd(best, _mm_loadu_pd(data + i));
+        }
+        alignas(16) double lanes[2];
+        _mm_store_pd(lanes, best);
+        result = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+    }
+#endif
+    for (; i < count; i++) {
+        if (data[i] > result) result = data[i];
+    }
+    return result;
+}
+
+bool NumericKernels::applyFloat(KernelOp op, const double* a, size_t aStep, const double* b, size_t bStep,
+                                double* out, size_t count) {
+    bool ok = true;
+    size_t i = 0;
+    
+#if defined(__AVX2__)
+    const __m256d zero = _mm256_setzero_pd();
+    for (; i + 4 <= count; i += 4) {
+        __m256d left = aStep ? _mm256_loadu_pd(a + i) : _mm256_set1_pd(a[0]);
+        __m256d right = bStep ? _mm256_loadu_pd(b + i) : _mm256_set1_pd(b[0]);
+        __m256d result;
+        switch (op) {
+            case KernelOp::Sumar: result = _mm256_add_pd(left, right); break;
+            case KernelOp::Restar: result = _mm256_sub_pd(left, right); break;
+            case KernelOp::Multiplicar: result = _mm256_mul_pd(left, right); break;
+            default: {
+                // Los divisores cero dan 0, igual que la division normal del lenguaje
+                __m256d nonZero = _mm256_cmp_pd(right, zero, _CMP_NEQ_OQ);
+                if (_mm256_movemask_pd(nonZero) != 0xF) ok = false;
+                result = _mm256_and_pd(_mm256_div_pd(left, right), nonZero);
+                break;
+            }
+        }
+        _mm256_storeu_pd(out + i, result);
+    }
+#elif defined(__SSE2__)
+    const __m128d zero = _mm_setzero_pd();
+    for (; i + 2 <= count; i += 2) {
+        __m128d left = aStep ? _mm_loadu_pd(a + i) : _mm_set1_pd(a[0]);
+        __m128d right = bStep ? _mm_loadu_pd(b + i) : _mm_set1_pd(b[0]);
+        __m128d result;
+        switch (op) {
+            case KernelOp::Sumar: result = _mm_add_pd(left, right); break;
+            case KernelOp::Restar: result = _mm_sub_pd(left, right); break;
+            case KernelOp::Multiplicar: result = _mm_mul_pd(left, right); break;
+            default: {
+                __m128d nonZero = _mm_cmpneq_pd(right, zero);
+                if (_mm_movemask_pd(nonZero) != 0x3) ok = false;
+                result = _mm_and_pd(_mm_div_pd(left, right), nonZero);
+                break;
+            }
+        }
+        _mm_storeu_pd(out + i, result);
+    }
+#endif
+    
+    for (; i < count; i++) {
+        double left = a[i * aStep];
+        double right = b[i * bStep];
+        switch (op) {
+            case KernelOp::Sumar: out[i] = left + right; break;
+            case KernelOp::Restar: out[i] = left - right; break;
+            case KernelOp::Multiplicar: out[i] = left * right; break;
+            default:
+                if (right == 0.0) {
+                    ok = false;
+                    out[i] = 0.0;
+                } else {
+                    out[i] = left / right;
+                }
+                break;
+        }
+    }
+    return ok;
+}
+
+bool NumericKernels::applyInt(KernelOp op, const long long* a, size_t aStep, const long long* b, size_t bStep,
+                              long long* out, size_t count) {
+    bool ok = true;
+    size_t i = 0;
+    
+    // Sumas y restas de 64 bits existen en SSE2 y AVX2; multiplicar y dividir van en escalar
+#if defined(__AVX2__)
+    if (op == KernelOp::Sumar || op == KernelOp::Restar) {
+        for (; i + 4 <= count; i += 4) {
+            __m256i left = aStep ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)) : _mm256_set1_epi64x(a[0]);
+            __m256i right = bStep ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)) : _mm256_set1_epi64x(b[0]);
+            __m256i result = op == KernelOp::Sumar ? _mm256_add_epi64(left, right) : _mm256_sub_epi64(left, right);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+        }
+    }
+#elif defined(__SSE2__)
+    if (op == KernelOp::Sumar || op == KernelOp::Restar) {
+        for (; i + 2 <= count; i += 2) {
+            __m128i left = aStep ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)) : _mm_set1_epi64x(a[0]);
+            __m128i right = bStep ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)) : _mm_set1_epi64x(b[0]);
+            __m128i result = op == KernelOp::Sumar ? _mm_add_epi64(left, right) : _mm_sub_epi64(left, right);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), result);
+        }
+    }
+#endif
+    
+    for (; i < count; i++) {
+        long long left = a[i * aStep];
+        long long right = b[i * bStep];
+        switch (op) {
+            case KernelOp::Sumar: out[i] = left + right; break;
+            case KernelOp::Restar: out[i] = left - right; break;
+            case KernelOp::Multiplicar: out[i] = left * right; break;
+            default:
+                if (right == 0) {
+                    ok = false;
+                    out[i] = 0;
+                } else {
+                    out[i] = left / right;
+                }
+                break;
+        }
+    }
+    return ok;
+}
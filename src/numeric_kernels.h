@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+
+enum class KernelOp : unsigned char { Sumar, Restar, Multiplicar, Dividir };
+
+// Operaciones sobre numeros contiguos para las listas numericas.
+// Con -mavx2 se usan instrucciones AVX2; en x86-64 siempre hay SSE2;
+// en cualquier otra plataforma queda el bucle escalar.
+class NumericKernels {
+public:
+    static long long sumInt(const long long* data, size_t count);
+    static double sumFloat(const double* data, size_t count);
+    static long long minInt(const long long* data, size_t count);
+    static long long maxInt(const long long* data, size_t count);
+    static double minFloat(const double* data, size_t count);
+    static double maxFloat(const double* data, size_t count);
+    
+    // out[i] = a[i] op b[i]. Un paso 0 repite siempre el primer valor (lista con numero).
+    // Devuelven false si hubo alguna division por cero; ese elemento queda en 0.
+    static bool applyFloat(KernelOp op, const double* a, size_t aStep, const double* b, size_t bStep,
+                           double* out, size_t count);
+    static bool applyInt(KernelOp op, const long long* a, size_t aStep, const long long* b, size_t bStep,
+                         long long* out, size_t count);
+};
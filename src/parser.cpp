@@ -0,0 +1,218 @@
+#include "parser.h"
+#include "utils.h"
+#include "command_table.h"
+#include "string_table.h"
+
+std::vector<std::string> Parser::splitArguments(std::string_view args) {
+    std::vector<std::string> params;
+    for (const auto& part : Utils::splitExpression(args)) {
+        params.emplace_back(part.first);
+    }
+    return params;
+}
+
+static bool endsWith(std::string_view text, std::string_view suffix) {
+    return text.size() >= suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+}
+
+// lista[i] o dic[clave]: separa el nombre de la variable y la expresion del indice
+static void splitTarget(std::string_view target, Command& cmd) {
+    size_t bracket = target.find('[');
+    if (bracket != std::string_view::npos && target.back() == ']') {
+        cmd.index = std::string(Utils::trim(target.substr(bracket + 1, target.length() - bracket - 2)));
+        target = Utils::trim(target.substr(0, bracket));
+    }
+    cmd.name = std::string(target);
+}
+
+static void stripColon(std::string& text) {
+    if (!text.empty() && text.back() == ':') {
+        text.pop_back();
+    }
+}
+
+Command Parser::parseLine(std::string_view line, int lineNumber) {
+    Command cmd;
+    cmd.type = CommandType::Desconocido;
+    cmd.text = std::string(line);
+    cmd.slot = -1;
+    cmd.symbol = -1;
+    cmd.blockEnd = -1;
+    cmd.nextBranch = -1;
+    cmd.line = lineNumber;
+    
+    // La primera palabra decide el comando con una sola busqueda en la tabla
+    size_t wordEnd = line.find_first_of(" :");
+    const CommandSpec* spec = CommandTable::find(std::string(line.substr(0, wordEnd)));
+    if (!spec) return cmd;
+    
+    bool hasArgs = wordEnd != std::string_view::npos && line[wordEnd] == ' ';
+    std::string_view rest = hasArgs ? line.substr(wordEnd + 1) : std::string_view();
+    
+    if (spec->syntax == CommandSyntax::Texto || spec->syntax == CommandSyntax::Argumentos) {
+        if (!hasArgs) return cmd;
+        cmd.type = spec->type;
+        cmd.args = std::string(rest);
+        if (spec->syntax == CommandSyntax::Argumentos) {
+            cmd.params = splitArguments(cmd.args);
+        }
+        return cmd;
+    }
+    
+    switch (spec->type) {
+        case CommandType::Ingrediente: {
+            if (!hasArgs) break;
+            cmd.type = CommandType::Ingrediente;
+            cmd.args = std::string(rest);
+            size_t equalPos = rest.find(" = ");
+            if (equalPos != std::string_view::npos) {
+                // ingrediente lista[i] = valor cambia un solo elemento
+                splitTarget(Utils::trim(rest.substr(0, equalPos)), cmd);
+                cmd.expr = std::string(Utils::trim(rest.substr(equalPos + 3)));
+                if (Utils::isValidVariableName(cmd.name)) {
+                    cmd.slot = symbols.resolve(cmd.name);
+                }
+            }
+            break;
+        }
+        case CommandType::Quitar:
+            if (!hasArgs) break;
+            cmd.type = CommandType::Quitar;
+            cmd.args = std::string(rest);
+            splitTarget(Utils::trim(rest), cmd);
+            if (Utils::isValidVariableName(cmd.name)) {
+                cmd.slot = symbols.resolve(cmd.name);
+            }
+            break;
+        case CommandType::Probar:
+        case CommandType::Sino:
+        case CommandType::Mientras:
+            if (!hasArgs) break;
+            cmd.type = spec->type;
+            cmd.args = std::string(rest);
+            cmd.expr = cmd.args;
+            stripColon(cmd.expr);
+            break;
+        case CommandType::Repetir:
+            if (!hasArgs || !endsWith(rest, " veces:")) break;
+            cmd.type = CommandType::Repetir;
+            cmd.args = std::string(rest);
+            cmd.expr = std::string(Utils::trim(rest.substr(0, rest.size() - 7)));
+            break;
+        case CommandType::ParaCada: {
+            // "para cada x en lista:"
+            if (rest.substr(0, 5) != "cada " || rest.find(" en ") == std::string_view::npos) break;
+            cmd.type = CommandType::ParaCada;
+            std::string_view header = rest.substr(5);
+            cmd.args = std::string(header);
+            size_t enPos = header.find(" en ");
+            cmd.name = std::string(Utils::trim(header.substr(0, enPos)));
+            cmd.expr = std::string(Utils::trim(header.substr(enPos + 4)));
+            stripColon(cmd.expr);
+            if (Utils::isValidVariableName(cmd.name)) {
+                cmd.slot = symbols.resolve(cmd.name);
+            }
+            break;
+        }
+        case CommandType::Alternativa:
+            if (line == "alternativa:") cmd.type = CommandType::Alternativa;
+            break;
+        case CommandType::Listo:
+            if (line == "listo") cmd.type = CommandType::Listo;
+            break;
+        case CommandType::Receta: {
+            if (!hasArgs) break;
+            cmd.args = std::string(rest);
+            size_t parenPos = rest.find('(');
+            if (parenPos == std::string_view::npos) {
+                cmd.type = CommandType::Receta;
+                break;
+            }
+            
+            cmd.type = CommandType::RecetaDefinicion;
+            size_t parenEnd = rest.find(')');
+            if (parenEnd != std::string_view::npos && parenEnd > parenPos) {
+                cmd.name = std::string(Utils::trim(rest.substr(0, parenPos)));
+                cmd.symbol = StringTable::intern(cmd.name);
+                std::vector<std::string_view> params = Utils::parseParameters(Utils::trim(rest.substr(parenPos + 1, parenEnd - parenPos - 1)));
+                cmd.params.assign(params.begin(), params.end());
+                for (const std::string& param : cmd.params) {
+                    cmd.paramSlots.push_back(symbols.resolve(param));
+                }
+            }
+            break;
+        }
+        case CommandType::Cocinar: {
+            if (!hasArgs) break;
+            cmd.type = CommandType::Cocinar;
+            cmd.args = std::string(rest);
+            size_t parenPos = rest.find('(');
+            size_t parenEnd = rest.find(')');
+            if (parenPos != std::string_view::npos && parenEnd != std::string_view::npos && parenEnd > parenPos) {
+                cmd.name = std::string(Utils::trim(rest.substr(0, parenPos)));
+                cmd.symbol = StringTable::intern(cmd.name);
+                std::vector<std::string_view> params = Utils::parseParameters(Utils::trim(rest.substr(parenPos + 1, parenEnd - parenPos - 1)));
+                cmd.params.assign(params.begin(), params.end());
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    
+    return cmd;
+}
+
+// Enlaza cada bloque con su listo y cada rama con la siguiente, una sola vez
+void Parser::resolveBlocks(std::vector<Command>& program) {
+    struct OpenBlock {
+        int start;
+        int lastBranch;
+    };
+    std::vector<OpenBlock> open;
+    
+    for (int i = 0; i < static_cast<int>(program.size()); i++) {
+        Command& cmd = program[i];
+        switch (cmd.type) {
+            case CommandType::Probar:
+            case CommandType::Repetir:
+            case CommandType::Mientras:
+            case CommandType::ParaCada:
+            case CommandType::RecetaDefinicion:
+                open.push_back({i, i});
+                break;
+            case CommandType::Sino:
+            case CommandType::Alternativa:
+                if (!open.empty() && program[open.back().start].type == CommandType::Probar) {
+                    program[open.back().lastBranch].nextBranch = i;
+                    open.back().lastBranch = i;
+                }
+                break;
+            case CommandType::Listo:
+                if (!open.empty()) {
+                    program[open.back().start].blockEnd = i;
+                    program[open.back().lastBranch].nextBranch = i;
+                    // El listo apunta a la cabecera: es el salto de vuelta de los bucles
+                    cmd.blockEnd = open.back().start;
+                    open.pop_back();
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+std::shared_ptr<const std::vector<Command>> Parser::parse(const std::vector<std::string>& lines) {
+    auto program = std::make_shared<std::vector<Command>>();
+    program->reserve(lines.size());
+    
+    for (size_t i = 0; i < lines.size(); i++) {
+        std::string_view line = Utils::trim(Utils::removeComments(lines[i]));
+        if (line.empty()) continue;
+        program->push_back(parseLine(line, static_cast<int>(i) + 1));
+    }
+    
+    resolveBlocks(*program);
+    return program;
+}
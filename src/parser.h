@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include "structures.h"
+#include "symbol_table.h"
+
+class Parser {
+private:
+    SymbolTable& symbols;
+    
+    Command parseLine(std::string_view line, int lineNumber);
+    static std::vector<std::string> splitArguments(std::string_view args);
+    static void resolveBlocks(std::vector<Command>& program);
+
+public:
+    explicit Parser(SymbolTable& symbols) : symbols(symbols) {}
+    
+    std::shared_ptr<const std::vector<Command>> parse(const std::vector<std::string>& lines);
+};
@@ -0,0 +1,86 @@
+#include "random_generator.h"
+#include <random>
+#include <utility>
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// Sin semilla explicita cada ejecucion empieza en un punto distinto
+RandomGenerator::RandomGenerator() {
+    std::random_device rd;
+    seed((static_cast<uint64_t>(rd()) << 32) ^ rd());
+}
+
+// splitmix64 reparte la semilla por los cuatro estados (nunca quedan todos en cero)
+void RandomGenerator::seed(uint64_t value) {
+    for (uint64_t& word : state) {
+        value += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = value;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        word = z ^ (z >> 31);
+    }
+}
+
+uint64_t RandomGenerator::next() {
+    uint64_t result = rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+    
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    
+    return result;
+}
+
+// Entero en [0, span) sin sesgo (metodo de Lemire: casi nunca necesita dividir)
+static uint64_t boundedFrom(uint64_t raw, uint64_t span, RandomGenerator& generator) {
+    unsigned __int128 product = static_cast<unsigned __int128>(raw) * span;
+    uint64_t low = static_cast<uint64_t>(product);
+    if (low < span) {
+        uint64_t threshold = -span % span;
+        while (low < threshold) {
+            product = static_cast<unsigned __int128>(generator.next()) * span;
+            low = static_cast<uint64_t>(product);
+        }
+    }
+    return static_cast<uint64_t>(product >> 64);
+}
+
+long long RandomGenerator::nextInt(long long min, long long max) {
+    if (min > max) std::swap(min, max);
+    uint64_t span = static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1;
+    if (span == 0) return static_cast<long long>(next());   // rango completo de 64 bits
+    return static_cast<long long>(static_cast<uint64_t>(min) + boundedFrom(next(), span, *this));
+}
+
+// 53 bits altos -> [0, 1) con toda la precision de un double
+double RandomGenerator::nextDouble(double min, double max) {
+    double unit = static_cast<double>(next() >> 11) * 0x1.0p-53;
+    return min + unit * (max - min);
+}
+
+void RandomGenerator::fillInts(long long* out, size_t count, long long min, long long max) {
+    if (min > max) std::swap(min, max);
+    uint64_t* raw = reinterpret_cast<uint64_t*>(out);
+    for (size_t i = 0; i < count; i++) {
+        raw[i] = next();
+    }
+    
+    uint64_t span = static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1;
+    if (span == 0) return;
+    for (size_t i = 0; i < count; i++) {
+        raw[i] = static_cast<uint64_t>(min) + boundedFrom(raw[i], span, *this);
+    }
+}
+
+void RandomGenerator::fillDoubles(double* out, size_t count, double min, double max) {
+    double scale = (max - min) * 0x1.0p-53;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = min + static_cast<double>(next() >> 11) * scale;
+    }
+}
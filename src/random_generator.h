@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// Generador xoshiro256** propio de cada interprete. Con la misma semilla
+// produce siempre la misma secuencia, en cualquier maquina.
+class RandomGenerator {
+private:
+    uint64_t state[4];
+
+public:
+    RandomGenerator();
+    
+    void seed(uint64_t value);
+    uint64_t next();
+    
+    long long nextInt(long long min, long long max);
+    double nextDouble(double min, double max);
+    
+    // Llena out de una vez: primero los numeros crudos y luego el ajuste al rango
+    void fillInts(long long* out, size_t count, long long min, long long max);
+    void fillDoubles(double* out, size_t count, double min, double max);
+};
@@ -0,0 +1,28 @@
+#include "string_table.h"
+
+// deque: las cadenas no se mueven al crecer, las vistas del mapa siguen validas
+std::deque<std::string>& StringTable::texts() {
+    static std::deque<std::string> storage;
+    return storage;
+}
+
+std::unordered_map<std::string_view, int>& StringTable::ids() {
+    static std::unordered_map<std::string_view, int> index;
+    return index;
+}
+
+int StringTable::intern(std::string_view text) {
+    auto it = ids().find(text);
+    if (it != ids().end()) {
+        return it->second;
+    }
+    
+    int id = static_cast<int>(texts().size());
+    texts().emplace_back(text);
+    ids().emplace(texts().back(), id);
+    return id;
+}
+
+const std::string& StringTable::text(int id) {
+    return texts()[id];
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+
+// Tabla global de textos internados: cada texto distinto recibe un numero
+// estable, asi los nombres se comparan como enteros y se hashean una vez
+class StringTable {
+private:
+    static std::deque<std::string>& texts();
+    static std::unordered_map<std::string_view, int>& ids();
+
+public:
+    static int intern(std::string_view text);
+    static const std::string& text(int id);
+};
@@ -3,13 +3,50 @@
 #include <vector>
 #include <map>
 #include <chrono>
+#include <memory>
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
+struct ExprNode;
+
+enum class CommandType {
+    Hornear, Ingrediente, Probar, Sino, Alternativa, Listo,
+    Repetir, Mientras, ParaCada,
+    RecetaDefinicion, Cocinar, Receta, Mostrador, Escribir, Libro, Discord,
+    Juego, Objeto, Mover, Posicionar, Ocultar, Quitar, Semilla, Desconocido
+};
+
+// Linea de programa ya analizada: se ejecuta sin volver a tocar el texto original
+struct Command {
+    CommandType type;
+    std::string text;                 // linea sin comentarios ni espacios
+    std::string args;                 // texto tras la palabra clave
+    std::string name;                 // variable de ingrediente/para cada o nombre de receta
+    int symbol;                       // receta/cocinar: nombre internado (-1 si no hay)
+    std::string expr;                 // valor, condicion, veces de repetir o lista de para cada
+    std::string index;                // ingrediente/quitar lista[i]: expresion del indice
+    std::vector<std::string> params;  // argumentos ya separados
+    int slot;                         // ingrediente/para cada: indice de la variable destino
+    std::vector<int> paramSlots;      // receta: indices de los parametros
+    int blockEnd;                     // probar/bucle/receta: indice de su listo (-1 si falta)
+    int nextBranch;                   // probar/sino/alternativa: siguiente rama o listo
+    int line;                         // numero de linea en el archivo (desde 1)
+    
+    // Arboles de las expresiones: el evaluador los guarda aqui la primera vez que
+    // las analiza, y desde entonces se evaluan sin volver a buscar el texto
+    mutable const ExprNode* exprTree = nullptr;
+    mutable const ExprNode* argsTree = nullptr;
+    mutable const ExprNode* indexTree = nullptr;
+    mutable std::vector<const ExprNode*> paramTrees;
+};
+
 struct Function {
     std::vector<std::string> parameters;
-    std::vector<std::string> body;
+    std::vector<int> parameterSlots;
+    std::shared_ptr<const std::vector<Command>> code;
+    int bodyStart;
+    int bodyEnd;
     int startLine;
 };
 
@@ -24,11 +61,12 @@ struct WindowInfo {
     HWND hwnd;
     HWND textArea;
     std::string title;
+    int titleId;                      // titulo internado en StringTable
     std::string color;
     bool isActive;
     std::wstring content;
     bool isGameWindow;
-    std::map<std::string, GameObject> gameObjects;
+    std::map<int, GameObject> gameObjects;   // por nombre internado
     bool keysPressed[256];
     std::chrono::steady_clock::time_point lastUpdate;
     bool gameRunning;
@@ -0,0 +1,57 @@
+#include "symbol_table.h"
+
+int SymbolTable::resolve(const std::string& name) {
+    auto it = slots.find(name);
+    if (it != slots.end()) {
+        return it->second;
+    }
+    
+    int slot = static_cast<int>(frame.size());
+    slots.emplace(name, slot);
+    names.push_back(name);
+    frame.emplace_back();
+    savedIn.push_back(0);
+    return slot;
+}
+
+int SymbolTable::lookup(const std::string& name) const {
+    auto it = slots.find(name);
+    return it != slots.end() ? it->second : -1;
+}
+
+const Value* SymbolTable::find(const std::string& name) const {
+    int slot = lookup(name);
+    return slot != -1 ? &frame[slot] : nullptr;
+}
+
+void SymbolTable::assign(int slot, Value value) {
+    if (!callFrames.empty() && savedIn[slot] != callFrames.back().id) {
+        savedIn[slot] = callFrames.back().id;
+        undoLog.push_back({slot, std::move(frame[slot])});
+    }
+    frame[slot] = std::move(value);
+}
+
+// Acceso para modificar el valor en su sitio; guarda una copia para deshacer
+Value& SymbolTable::modify(int slot) {
+    if (!callFrames.empty() && savedIn[slot] != callFrames.back().id) {
+        savedIn[slot] = callFrames.back().id;
+        undoLog.push_back({slot, frame[slot]});
+    }
+    return frame[slot];
+}
+
+void SymbolTable::pushFrame() {
+    callFrames.push_back({undoLog.size(), nextFrameId++});
+}
+
+void SymbolTable::popFrame() {
+    size_t mark = callFrames.back().undoMark;
+    callFrames.pop_back();
+    
+    while (undoLog.size() > mark) {
+        UndoEntry& entry = undoLog.back();
+        frame[entry.slot] = std::move(entry.previous);
+        undoLog.pop_back();
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "value.h"
+
+// Asigna a cada nombre de variable un indice fijo dentro de un marco plano.
+// Cada llamada a receta abre un marco: la primera escritura de una variable
+// guarda su valor anterior y al salir solo se restauran esas variables.
+class SymbolTable {
+private:
+    struct UndoEntry {
+        int slot;
+        Value previous;
+    };
+    struct CallFrame {
+        size_t undoMark;
+        unsigned id;
+    };
+    
+    std::unordered_map<std::string, int> slots;
+    std::vector<std::string> names;
+    std::vector<Value> frame;
+    std::vector<unsigned> savedIn;     // ultimo marco que guardo cada variable
+    std::vector<UndoEntry> undoLog;
+    std::vector<CallFrame> callFrames;
+    unsigned nextFrameId = 1;
+
+public:
+    int resolve(const std::string& name);
+    int lookup(const std::string& name) const;
+    const std::string& nameOf(int slot) const { return names[slot]; }
+    
+    const Value& at(int slot) const { return frame[slot]; }
+    const Value* find(const std::string& name) const;
+    void assign(int slot, Value value);
+    Value& modify(int slot);
+    
+    void pushFrame();
+    void popFrame();
+    int size() const { return static_cast<int>(frame.size()); }
+};
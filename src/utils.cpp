@@ -1,26 +1,45 @@
 #include "utils.h"
-#include <sstream>
+#include "command_table.h"
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 
-std::vector<std::string> Utils::keywords = {
-    "hornear", "ingrediente", "probar", "alternativa", "sino", "listo", 
-    "pedir_numero", "pedir_nombre", "receta", "cocinar", "mostrador",
-    "entero", "texto", "decimal", "lista", "escribir", "boton", "entrada", "libro",
-    "discord",
-    "juego", "objeto", "mover", "dibujar", "colision", "tecla", "temporizador", 
-    "aleatorio", "posicionar", "objeto_x", "objeto_y", "ocultar"
-};
-
-std::string Utils::trim(const std::string& str) {
+// Las funciones de texto devuelven vistas sobre la cadena original, sin copiar
+std::string_view Utils::trim(std::string_view str) {
     size_t first = str.find_first_not_of(' ');
-    if (first == std::string::npos) return "";
+    if (first == std::string_view::npos) return {};
     size_t last = str.find_last_not_of(' ');
     return str.substr(first, (last - first + 1));
 }
 
+// Lectura de numeros sin excepciones: el texto entero debe ser el numero
+bool Utils::parseInteger(std::string_view text, long long& result) {
+    const char* begin = text.data();
+    const char* end = begin + text.length();
+    if (begin != end && *begin == '+') {
+        begin++;
+        // Solo un signo: "+-5" o "++5" no son numeros
+        if (begin != end && (*begin == '-' || *begin == '+')) return false;
+    }
+    
+    auto parsed = std::from_chars(begin, end, result);
+    return parsed.ec == std::errc() && parsed.ptr == end && begin != end;
+}
+
+bool Utils::parseDecimal(std::string_view text, double& result) {
+    const char* begin = text.data();
+    const char* end = begin + text.length();
+    if (begin != end && *begin == '+') {
+        begin++;
+        if (begin != end && (*begin == '-' || *begin == '+')) return false;
+    }
+    
+    auto parsed = std::from_chars(begin, end, result);
+    return parsed.ec == std::errc() && parsed.ptr == end && begin != end;
+}
+
 bool Utils::isKeyword(const std::string& word) {
-    return std::find(keywords.begin(), keywords.end(), word) != keywords.end();
+    return CommandTable::isKeyword(word);
 }
 
 bool Utils::isValidVariableName(const std::string& name) {
@@ -32,27 +51,9 @@ bool Utils::isValidVariableName(const std::string& name) {
     return true;
 }
 
-bool Utils::isStringExpression(const std::string& expr, const std::map<std::string, std::string>& stringVars) {
-    std::string trimmed = trim(expr);
-    if (trimmed.length() >= 2 && trimmed.front() == '"' && trimmed.back() == '"') return true;
-    if (stringVars.find(trimmed) != stringVars.end()) return true;
-    return false;
-}
-
-bool Utils::isFloatExpression(const std::string& value, const std::map<std::string, double>& floatVars) {
-    std::string trimmedValue = trim(value);
-    return trimmedValue.find('.') != std::string::npos || floatVars.find(trimmedValue) != floatVars.end();
-}
-
-bool Utils::isArrayExpression(const std::string& value, const std::map<std::string, std::vector<std::string>>& arrayVars) {
-    std::string trimmedValue = trim(value);
-    return (trimmedValue.length() >= 2 && trimmedValue.front() == '[' && trimmedValue.back() == ']') || 
-           arrayVars.find(trimmedValue) != arrayVars.end();
-}
-
-std::string Utils::removeComments(const std::string& line) {
+std::string_view Utils::removeComments(std::string_view line) {
     size_t commentPos = line.find('#');
-    if (commentPos != std::string::npos) {
+    if (commentPos != std::string_view::npos) {
         bool inQuotes = false;
         for (size_t i = 0; i < commentPos; i++) {
             if (line[i] == '"') {
@@ -66,31 +67,30 @@ std::string Utils::removeComments(const std::string& line) {
     return line;
 }
 
-std::vector<std::string> Utils::parseParameters(const std::string& paramStr) {
-    std::vector<std::string> params;
-    if (paramStr.empty()) return params;
+std::vector<std::string_view> Utils::parseParameters(std::string_view paramStr) {
+    std::vector<std::string_view> params;
     
-    std::stringstream ss(paramStr);
-    std::string param;
-    while (std::getline(ss, param, ',')) {
-        params.push_back(trim(param));
+    size_t start = 0;
+    while (start < paramStr.length()) {
+        size_t comma = paramStr.find(',', start);
+        if (comma == std::string_view::npos) comma = paramStr.length();
+        params.push_back(trim(paramStr.substr(start, comma - start)));
+        start = comma + 1;
     }
     return params;
 }
 
-std::vector<std::string> Utils::parseArray(const std::string& arrayStr) {
-    std::vector<std::string> elements;
+std::vector<std::string_view> Utils::parseArray(std::string_view arrayStr) {
     if (arrayStr.length() < 2 || arrayStr.front() != '[' || arrayStr.back() != ']') {
-        return elements;
+        return {};
     }
     
-    std::string content = arrayStr.substr(1, arrayStr.length() - 2);
-    return parseParameters(content);
+    return parseParameters(arrayStr.substr(1, arrayStr.length() - 2));
 }
 
-std::vector<std::pair<std::string, std::string>> Utils::splitExpression(const std::string& expr) {
-    std::vector<std::pair<std::string, std::string>> parts;
-    std::string current = "";
+std::vector<std::pair<std::string_view, std::string_view>> Utils::splitExpression(std::string_view expr) {
+    std::vector<std::pair<std::string_view, std::string_view>> parts;
+    size_t start = 0;
     bool inQuotes = false;
     int parenDepth = 0;
     
@@ -100,7 +100,6 @@ std::vector<std::pair<std::string, std::string>> Utils::splitExpression(const st
         // Manejar comillas
         if (c == '"' && (i == 0 || expr[i-1] != '\\')) {
             inQuotes = !inQuotes;
-            current += c;
             continue;
         }
         
@@ -114,20 +113,18 @@ std::vector<std::pair<std::string, std::string>> Utils::splitExpression(const st
         if (!inQuotes && parenDepth == 0) {
             // Solo buscar ", " para separación de parámetros
             if (c == ',' && i + 1 < expr.length() && expr[i+1] == ' ') {
-                parts.push_back({trim(current), ","});
-                current = "";
+                parts.push_back({trim(expr.substr(start, i - start)), ","});
+                start = i + 2;
                 i++; // Saltar el espacio después de la coma
                 continue;
             }
             // REMOVIDO: No procesar '+' como separador aquí
             // El '+' debe ser manejado por evaluateStringExpression, no por splitExpression
         }
-        
-        current += c;
     }
     
-    if (!current.empty()) {
-        parts.push_back({trim(current), ""});
+    if (start < expr.length()) {
+        parts.push_back({trim(expr.substr(start)), ""});
     }
     
     return parts;
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 #include <cctype>
@@ -10,19 +11,15 @@
 
 class Utils {
 public:
-    static std::string trim(const std::string& str);
+    static std::string_view trim(std::string_view str);
     static bool isKeyword(const std::string& word);
     static bool isValidVariableName(const std::string& name);
-    static bool isStringExpression(const std::string& expr, const std::map<std::string, std::string>& stringVars);
-    static bool isFloatExpression(const std::string& value, const std::map<std::string, double>& floatVars);
-    static bool isArrayExpression(const std::string& value, const std::map<std::string, std::vector<std::string>>& arrayVars);
-    static std::string removeComments(const std::string& line);
-    static std::vector<std::string> parseParameters(const std::string& paramStr);
-    static std::vector<std::string> parseArray(const std::string& arrayStr);
-    static std::vector<std::pair<std::string, std::string>> splitExpression(const std::string& expr);
+    static std::string_view removeComments(std::string_view line);
+    static bool parseInteger(std::string_view text, long long& result);
+    static bool parseDecimal(std::string_view text, double& result);
+    static std::vector<std::string_view> parseParameters(std::string_view paramStr);
+    static std::vector<std::string_view> parseArray(std::string_view arrayStr);
+    static std::vector<std::pair<std::string_view, std::string_view>> splitExpression(std::string_view expr);
     static COLORREF getColorFromName(const std::string& colorName);
     static int getVirtualKeyCode(const std::string& keyName);
-    
-private:
-    static std::vector<std::string> keywords;
 };
\ No newline at end of file
@@ -0,0 +1,333 @@
+#include "value.h"
+#include "utils.h"
+#include "dictionary.h"
+#include <sstream>
+#include <charconv>
+#include <algorithm>
+
+Value Value::fromInt(long long value) {
+    Value result;
+    result.type = ValueType::Entero;
+    result.intValue = value;
+    return result;
+}
+
+Value Value::fromFloat(double value) {
+    Value result;
+    result.type = ValueType::Decimal;
+    result.floatValue = value;
+    return result;
+}
+
+Value Value::fromText(std::string value) {
+    Value result;
+    result.type = ValueType::Texto;
+    if (value.length() <= InlineTextLength) {
+        value.copy(result.inlineText.data, value.length());
+        result.inlineText.length = static_cast<unsigned char>(value.length());
+    } else {
+        result.shared = std::make_shared<std::string>(std::move(value));
+    }
+    return result;
+}
+
+// Texto para escribir encima: un texto corto pasa a un bufer propio para poder crecer
+// y, si otro valor comparte el bufer, se copia antes
+std::string& Value::mutableText() {
+    if (!shared) {
+        shared = std::make_shared<std::string>(inlineText.data, inlineText.length);
+    } else if (shared.use_count() > 1) {
+        shared = std::make_shared<std::string>(text());
+    }
+    return text();
+}
+
+size_t ListData::size() const {
+    switch (kind) {
+        case ListKind::Entero: return ints.size();
+        case ListKind::Decimal: return floats.size();
+        default: return texts.size();
+    }
+}
+
+// Elige la representacion: enteros, decimales o texto si algun elemento no es numero
+Value Value::fromList(std::vector<std::string> value) {
+    std::vector<long long> ints;
+    ints.reserve(value.size());
+    bool allInts = !value.empty();
+    for (const std::string& item : value) {
+        long long number;
+        if (!Utils::parseInteger(item, number)) {
+            allInts = false;
+            break;
+        }
+        ints.push_back(number);
+    }
+    if (allInts) {
+        return fromIntList(std::move(ints));
+    }
+    
+    std::vector<double> floats;
+    floats.reserve(value.size());
+    bool allNumbers = !value.empty();
+    for (const std::string& item : value) {
+        double number;
+        if (!Utils::parseDecimal(item, number)) {
+            allNumbers = false;
+            break;
+        }
+        floats.push_back(number);
+    }
+    if (allNumbers) {
+        return fromFloatList(std::move(floats));
+    }
+    
+    auto list = std::make_shared<ListData>();
+    list->texts = std::move(value);
+    
+    Value result;
+    result.type = ValueType::Lista;
+    result.range = {0, list->size()};
+    result.shared = std::move(list);
+    return result;
+}
+
+Value Value::fromIntList(std::vector<long long> value) {
+    auto list = std::make_shared<ListData>();
+    list->kind = ListKind::Entero;
+    list->ints = std::move(value);
+    
+    Value result;
+    result.type = ValueType::Lista;
+    result.range = {0, list->size()};
+    result.shared = std::move(list);
+    return result;
+}
+
+Value Value::fromFloatList(std::vector<double> value) {
+    auto list = std::make_shared<ListData>();
+    list->kind = ListKind::Decimal;
+    list->floats = std::move(value);
+    
+    Value result;
+    result.type = ValueType::Lista;
+    result.range = {0, list->size()};
+    result.shared = std::move(list);
+    return result;
+}
+
+Value Value::newDictionary() {
+    Value result;
+    result.type = ValueType::Diccionario;
+    result.shared = std::make_shared<Dictionary>();
+    return result;
+}
+
+// Diccionario para escribir encima: si otro valor lo comparte se copia antes
+Dictionary& Value::mutableDictionary() {
+    if (shared.use_count() > 1) {
+        shared = std::make_shared<Dictionary>(dict());
+    }
+    return dict();
+}
+
+Value Value::listItem(size_t index) const {
+    switch (list().kind) {
+        case ListKind::Entero: return fromInt(listInts()[index]);
+        case ListKind::Decimal: return fromFloat(listFloats()[index]);
+        default: return parseLiteral(listText(index));
+    }
+}
+
+// Deja la lista con elementos propios del tipo pedido; solo copia si hace falta
+void Value::ownList(ListKind kind) {
+    if (isWholeList() && shared.use_count() == 1 && list().kind == kind) {
+        list().index.reset();
+        return;
+    }
+    
+    auto copy = std::make_shared<ListData>();
+    copy->kind = kind;
+    for (size_t i = 0; i < range.length; i++) {
+        switch (kind) {
+            case ListKind::Entero:
+                copy->ints.push_back(listInts()[i]);
+                break;
+            case ListKind::Decimal:
+                copy->floats.push_back(listItem(i).toFloat());
+                break;
+            default:
+                copy->texts.push_back(list().kind == ListKind::Texto ? listText(i) : listItem(i).toString());
+                break;
+        }
+    }
+    range = {0, copy->size()};
+    shared = std::move(copy);
+}
+
+// Cambia un elemento; un decimal en una lista de enteros la pasa a decimales y un texto a textos
+void Value::setListItem(size_t index, const Value& item) {
+    ListKind current = list().kind;
+    ListKind kind = ListKind::Texto;
+    if (current != ListKind::Texto && item.getType() == ValueType::Entero) {
+        kind = current;
+    } else if (current != ListKind::Texto && item.getType() == ValueType::Decimal) {
+        kind = ListKind::Decimal;
+    }
+    ownList(kind);
+    
+    switch (kind) {
+        case ListKind::Entero:
+            list().ints[index] = item.asInt();
+            break;
+        case ListKind::Decimal:
+            list().floats[index] = item.toFloat();
+            break;
+        default:
+            // Los textos se guardan como se escribirian en una lista literal
+            list().texts[index] = item.getType() == ValueType::Texto ? "\"" + std::string(item.asText()) + "\"" : item.toString();
+            break;
+    }
+}
+
+void Value::removeListItem(size_t index) {
+    ownList(list().kind);
+    switch (list().kind) {
+        case ListKind::Entero: list().ints.erase(list().ints.begin() + index); break;
+        case ListKind::Decimal: list().floats.erase(list().floats.begin() + index); break;
+        default: list().texts.erase(list().texts.begin() + index); break;
+    }
+    range.length--;
+}
+
+// Elementos [start, end) sin copiarlos; los limites se recortan al largo de la lista
+Value Value::listSlice(size_t start, size_t end) const {
+    end = std::min(end, range.length);
+    start = std::min(start, end);
+    
+    Value result = *this;
+    result.range = {range.offset + start, end - start};
+    return result;
+}
+
+long long Value::toInt() const {
+    switch (type) {
+        case ValueType::Entero: return intValue;
+        case ValueType::Decimal: return static_cast<long long>(floatValue);
+        default: return 0;
+    }
+}
+
+double Value::toFloat() const {
+    switch (type) {
+        case ValueType::Entero: return static_cast<double>(intValue);
+        case ValueType::Decimal: return floatValue;
+        default: return 0.0;
+    }
+}
+
+std::string Value::toString() const {
+    if (type == ValueType::Texto) {
+        return std::string(asText());
+    }
+    
+    std::string result;
+    result.reserve(textLength());
+    appendTo(result);
+    return result;
+}
+
+// Longitud del texto del valor: exacta para textos y listas, maxima para numeros
+size_t Value::textLength() const {
+    switch (type) {
+        case ValueType::Entero:
+        case ValueType::Decimal:
+            return 24;
+        case ValueType::Texto:
+            return asText().length();
+        case ValueType::Lista: {
+            size_t count = range.length;
+            size_t length = count == 0 ? 0 : (count - 1) * 2;
+            if (list().isNumeric()) {
+                return length + count * 20;
+            }
+            for (size_t i = 0; i < count; i++) {
+                length += listText(i).length();
+            }
+            return length;
+        }
+        case ValueType::Diccionario:
+            return 2 + dict().size() * 16;
+        case ValueType::Vacio:
+            break;
+    }
+    return 0;
+}
+
+void Value::appendInt(long long value, std::string& out) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Escribe el texto del valor al final de out, sin cadenas intermedias
+void Value::appendTo(std::string& out) const {
+    switch (type) {
+        case ValueType::Entero:
+            appendInt(intValue, out);
+            break;
+        case ValueType::Decimal:
+            out += formatDecimal(floatValue);
+            break;
+        case ValueType::Texto:
+            out += asText();
+            break;
+        case ValueType::Lista:
+            for (size_t i = 0; i < range.length; i++) {
+                if (i > 0) out += ", ";
+                switch (list().kind) {
+                    case ListKind::Entero: appendInt(listInts()[i], out); break;
+                    case ListKind::Decimal: out += formatDecimal(listFloats()[i]); break;
+                    default: out += listText(i); break;
+                }
+            }
+            break;
+        case ValueType::Diccionario:
+            dict().appendTo(out);
+            break;
+        case ValueType::Vacio:
+            break;
+    }
+}
+
+std::string Value::formatDecimal(double value) {
+    if (value == static_cast<long long>(value)) {
+        return std::to_string(static_cast<long long>(value));
+    }
+    
+    std::ostringstream oss;
+    oss.precision(2);
+    oss << std::fixed << value;
+    std::string str = oss.str();
+    while (str.length() > 1 && str.back() == '0' && str[str.length()-2] != '.') {
+        str.pop_back();
+    }
+    return str;
+}
+
+// Convierte un elemento de lista o dato de texto al valor con el tipo que aparenta
+Value Value::parseLiteral(const std::string& text) {
+    if (text.length() >= 2 && text.front() == '"' && text.back() == '"') {
+        return fromText(text.substr(1, text.length() - 2));
+    }
+    
+    if (text.find('.') != std::string::npos) {
+        double value;
+        if (Utils::parseDecimal(text, value)) return fromFloat(value);
+    } else {
+        long long value;
+        if (Utils::parseInteger(text, value)) return fromInt(value);
+    }
+    
+    return fromText(text);
+}
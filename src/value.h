@@ -0,0 +1,113 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+enum class ValueType : unsigned char { Vacio, Entero, Decimal, Texto, Lista, Diccionario };
+
+class Dictionary;
+
+// Tipo de los elementos de una lista: si todos son numeros se guardan contiguos
+enum class ListKind : unsigned char { Texto, Entero, Decimal };
+
+// Indice valor -> primera posicion para buscar sin recorrer la lista
+struct ListIndex {
+    std::unordered_map<long long, size_t> ints;
+    std::unordered_map<double, size_t> floats;
+    std::unordered_map<std::string, size_t> texts;
+};
+
+struct ListData {
+    ListKind kind = ListKind::Texto;
+    std::vector<std::string> texts;   // elementos tal como se escribieron
+    std::vector<long long> ints;
+    std::vector<double> floats;
+    mutable std::unique_ptr<ListIndex> index;   // se crea al buscar y se borra al cambiar un elemento
+    
+    size_t size() const;
+    bool isNumeric() const { return kind != ListKind::Texto; }
+};
+
+// Valor de una variable: una etiqueta de tipo, una union con los numeros o un texto
+// corto y un unico puntero compartido cuyo contenido (texto largo, lista o diccionario)
+// indica la etiqueta. Copiar un valor no copia sus elementos; se copian solo al
+// modificarlos si otro valor los comparte.
+class Value {
+private:
+    // Tramo de la lista que ve este valor: una rebanada comparte los elementos del original
+    struct ListRange {
+        size_t offset;
+        size_t length;
+    };
+    
+    // Hasta este largo el texto se guarda dentro del valor, sin pedir memoria
+    static constexpr size_t InlineTextLength = 15;
+    struct InlineText {
+        char data[InlineTextLength];
+        unsigned char length;
+    };
+    
+    ValueType type;
+    union {
+        long long intValue;
+        double floatValue;
+        ListRange range;
+        InlineText inlineText;
+    };
+    std::shared_ptr<void> shared;   // std::string largo, ListData o Dictionary segun type
+    
+    std::string& text() const { return *static_cast<std::string*>(shared.get()); }
+    ListData& list() const { return *static_cast<ListData*>(shared.get()); }
+    Dictionary& dict() const { return *static_cast<Dictionary*>(shared.get()); }
+    void ownList(ListKind kind);
+
+public:
+    Value() : type(ValueType::Vacio), intValue(0) {}
+    
+    static Value fromInt(long long value);
+    static Value fromFloat(double value);
+    static Value fromText(std::string value);
+    static Value fromList(std::vector<std::string> value);
+    static Value fromIntList(std::vector<long long> value);
+    static Value fromFloatList(std::vector<double> value);
+    static Value newDictionary();
+    
+    ValueType getType() const { return type; }
+    bool isEmpty() const { return type == ValueType::Vacio; }
+    bool isNumeric() const { return type == ValueType::Entero || type == ValueType::Decimal; }
+    
+    long long asInt() const { return intValue; }
+    double asFloat() const { return floatValue; }
+    std::string_view asText() const {
+        if (type != ValueType::Texto) return {};
+        return shared ? std::string_view(text()) : std::string_view(inlineText.data, inlineText.length);
+    }
+    std::string& mutableText();
+    bool isNumericList() const { return type == ValueType::Lista && list().isNumeric(); }
+    bool isWholeList() const { return range.offset == 0 && range.length == list().size(); }
+    const ListData& listData() const { return list(); }
+    ListKind listKind() const { return list().kind; }
+    size_t listSize() const { return range.length; }
+    const long long* listInts() const { return list().ints.data() + range.offset; }
+    const double* listFloats() const { return list().floats.data() + range.offset; }
+    const std::string& listText(size_t index) const { return list().texts[range.offset + index]; }
+    Value listItem(size_t index) const;
+    Value listSlice(size_t start, size_t end) const;
+    void setListItem(size_t index, const Value& item);
+    void removeListItem(size_t index);
+    
+    const Dictionary& asDictionary() const { return dict(); }
+    Dictionary& mutableDictionary();
+    
+    long long toInt() const;
+    double toFloat() const;
+    std::string toString() const;
+    size_t textLength() const;
+    void appendTo(std::string& out) const;
+    
+    static Value parseLiteral(const std::string& text);
+    static std::string formatDecimal(double value);
+    static void appendInt(long long value, std::string& out);
+};
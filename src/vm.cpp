@@ -0,0 +1,233 @@
+#include "vm.h"
+#include <iostream>
+
+BytecodeCompiler::BytecodeCompiler(const std::vector<Command>& program)
+    : code(program), entryPoints(program.size() + 1, -1) {}
+
+int BytecodeCompiler::emit(OpCode op, int command, int target) {
+    instructions.push_back({op, command, target});
+    return static_cast<int>(instructions.size()) - 1;
+}
+
+int BytecodeCompiler::compileConditional(int line) {
+    int listoLine = code[line].blockEnd;
+    if (listoLine == -1) {
+        // El ejecutor informa del error y sigue con la linea siguiente
+        emit(OpCode::Comando, line);
+        return line;
+    }
+    
+    std::vector<int> exits;
+    int branchLine = line;
+    while (branchLine < listoLine) {
+        int nextBranch = code[branchLine].nextBranch;
+        
+        if (code[branchLine].type == CommandType::Alternativa) {
+            compileRange(branchLine + 1, nextBranch);
+            break;
+        }
+        
+        int test = emit(OpCode::SaltarSiFalso, branchLine);
+        compileRange(branchLine + 1, nextBranch);
+        exits.push_back(emit(OpCode::Saltar, branchLine));
+        instructions[test].target = static_cast<int>(instructions.size());
+        branchLine = nextBranch;
+    }
+    
+    for (int exit : exits) {
+        instructions[exit].target = static_cast<int>(instructions.size());
+    }
+    return listoLine;
+}
+
+int BytecodeCompiler::compileLoop(int line) {
+    int listoLine = code[line].blockEnd;
+    if (listoLine == -1) {
+        emit(OpCode::Comando, line);
+        return line;
+    }
+    
+    // Cabecera, cuerpo ya decodificado y salto de vuelta a la cabecera
+    int header;
+    switch (code[line].type) {
+        case CommandType::Repetir:
+            emit(OpCode::RepetirInicio, line);
+            header = emit(OpCode::RepetirPaso, line);
+            break;
+        case CommandType::ParaCada:
+            emit(OpCode::ParaCadaInicio, line);
+            header = emit(OpCode::ParaCadaPaso, line);
+            break;
+        default:
+            header = emit(OpCode::SaltarSiFalso, line);
+            break;
+    }
+    
+    compileRange(line + 1, listoLine);
+    emit(OpCode::Saltar, listoLine, header);
+    instructions[header].target = static_cast<int>(instructions.size());
+    return listoLine;
+}
+
+int BytecodeCompiler::compileRecetaDefinition(int line, int endLine) {
+    int bodyEnd = code[line].blockEnd == -1 ? endLine : code[line].blockEnd;
+    
+    int define = emit(OpCode::Definir, line);
+    entryPoints[line + 1] = static_cast<int>(instructions.size());
+    compileRange(line + 1, bodyEnd);
+    emit(OpCode::Retornar, line);
+    instructions[define].target = static_cast<int>(instructions.size());
+    return bodyEnd;
+}
+
+void BytecodeCompiler::compileRange(int startLine, int endLine) {
+    for (int i = startLine; i < endLine; i++) {
+        switch (code[i].type) {
+            case CommandType::Hornear: emit(OpCode::Hornear, i); break;
+            case CommandType::Ingrediente: emit(OpCode::Ingrediente, i); break;
+            case CommandType::Probar: i = compileConditional(i); break;
+            case CommandType::Repetir:
+            case CommandType::Mientras:
+            case CommandType::ParaCada: i = compileLoop(i); break;
+            case CommandType::RecetaDefinicion: i = compileRecetaDefinition(i, endLine); break;
+            case CommandType::Cocinar: emit(OpCode::Llamar, i); break;
+            case CommandType::Mostrador: emit(OpCode::Mostrador, i); break;
+            case CommandType::Escribir: emit(OpCode::Escribir, i); break;
+            case CommandType::Libro: emit(OpCode::Libro, i); break;
+            case CommandType::Receta: emit(OpCode::Receta, i); break;
+            case CommandType::Discord: emit(OpCode::Discord, i); break;
+            case CommandType::Juego: emit(OpCode::Juego, i); break;
+            case CommandType::Objeto: emit(OpCode::Objeto, i); break;
+            case CommandType::Mover: emit(OpCode::Mover, i); break;
+            case CommandType::Posicionar: emit(OpCode::Posicionar, i); break;
+            case CommandType::Ocultar: emit(OpCode::Ocultar, i); break;
+            case CommandType::Quitar: emit(OpCode::Quitar, i); break;
+            case CommandType::Semilla: emit(OpCode::Semilla, i); break;
+            case CommandType::Sino:
+            case CommandType::Alternativa:
+            case CommandType::Listo:
+                break;
+            case CommandType::Desconocido: emit(OpCode::Comando, i); break;
+        }
+    }
+}
+
+std::vector<Instruction> BytecodeCompiler::compile() {
+    instructions.clear();
+    instructions.reserve(code.size() + 1);
+    compileRange(0, static_cast<int>(code.size()));
+    emit(OpCode::Fin, -1);
+    return instructions;
+}
+
+VirtualMachine::VirtualMachine(CommandExecutor& exec) : executor(exec) {}
+
+void VirtualMachine::run(const std::vector<Command>& code, const std::vector<Instruction>& instructions,
+                         const std::vector<int>& entryPoints) {
+    std::vector<int> returnStack;
+    std::vector<LoopState> loops;
+    int endLine = static_cast<int>(code.size());
+    int pc = 0;
+    
+    // Las excepciones son raras: el bucle interno queda libre de manejadores
+    while (true) {
+        try {
+            while (true) {
+                const Instruction& ins = instructions[pc];
+                switch (ins.op) {
+                    case OpCode::Hornear: executor.executeHornear(code[ins.command]); pc++; break;
+                    case OpCode::Ingrediente: executor.executeIngrediente(code[ins.command]); pc++; break;
+                    case OpCode::Mostrador: executor.executeMostrador(code[ins.command]); pc++; break;
+                    case OpCode::Escribir: executor.executeEscribir(code[ins.command]); pc++; break;
+                    case OpCode::Libro: executor.executeLibro(code[ins.command]); pc++; break;
+                    case OpCode::Receta: executor.executeReceta(code[ins.command].args); pc++; break;
+                    case OpCode::Discord: executor.executeDiscord(code[ins.command]); pc++; break;
+                    case OpCode::Juego: executor.executeJuego(code[ins.command]); pc++; break;
+                    case OpCode::Objeto: executor.executeObjeto(code[ins.command]); pc++; break;
+                    case OpCode::Mover: executor.executeMover(code[ins.command]); pc++; break;
+                    case OpCode::Posicionar: executor.executePosicionar(code[ins.command]); pc++; break;
+                    case OpCode::Ocultar: executor.executeOcultar(code[ins.command]); pc++; break;
+                    case OpCode::Quitar: executor.executeQuitar(code[ins.command]); pc++; break;
+                    case OpCode::Semilla: executor.executeSemilla(code[ins.command]); pc++; break;
+                    case OpCode::SaltarSiFalso:
+                        pc = executor.evaluateBranchCondition(code[ins.command]) ? pc + 1 : ins.target;
+                        break;
+                    case OpCode::RepetirInicio:
+                        loops.push_back({0, Value(), 0});
+                        loops.back().remaining = executor.evaluateRepeatCount(code[ins.command]);
+                        pc++;
+                        break;
+                    case OpCode::RepetirPaso:
+                        if (loops.back().remaining-- > 0) {
+                            pc++;
+                        } else {
+                            loops.pop_back();
+                            pc = ins.target;
+                        }
+                        break;
+                    case OpCode::ParaCadaInicio:
+                        loops.push_back({0, Value::fromList({}), 0});
+                        loops.back().list = executor.evaluateForEachList(code[ins.command]);
+                        pc++;
+                        break;
+                    case OpCode::ParaCadaPaso: {
+                        LoopState& loop = loops.back();
+                        if (loop.index < loop.list.listSize()) {
+                            executor.assignLoopVariable(code[ins.command], loop.list, loop.index++);
+                            pc++;
+                        } else {
+                            loops.pop_back();
+                            pc = ins.target;
+                        }
+                        break;
+                    }
+                    case OpCode::Saltar:
+                        pc = ins.target;
+                        break;
+                    case OpCode::Definir: {
+                        int line = ins.command;
+                        executor.executeRecetaDefinition(code, line, endLine);
+                        pc = ins.target;
+                        break;
+                    }
+                    case OpCode::Llamar: {
+                        Function func;
+                        if (executor.enterReceta(code[ins.command], func)) {
+                            returnStack.push_back(pc + 1);
+                            pc = entryPoints[func.bodyStart];
+                        } else {
+                            pc++;
+                        }
+                        break;
+                    }
+                    case OpCode::Retornar:
+                        executor.leaveReceta();
+                        pc = returnStack.back();
+                        returnStack.pop_back();
+                        break;
+                    case OpCode::Comando: {
+                        int line = ins.command;
+                        executor.executeCommand(code, line, endLine);
+                        pc++;
+                        break;
+                    }
+                    case OpCode::Fin:
+                        return;
+                }
+            }
+        } catch (const std::exception& e) {
+            const Instruction& ins = instructions[pc];
+            std::cerr << "Error en la linea " << code[ins.command].line << ": " << e.what() << std::endl;
+            // Una condicion que falla cuenta como falsa: se sigue donde saltaria
+            pc = ins.op == OpCode::SaltarSiFalso ? ins.target : pc + 1;
+        }
+    }
+}
+
+void VirtualMachine::execute(std::shared_ptr<const std::vector<Command>> program) {
+    executor.loadProgram(program);
+    
+    BytecodeCompiler compiler(*program);
+    std::vector<Instruction> instructions = compiler.compile();
+    run(*program, instructions, compiler.getEntryPoints());
+}
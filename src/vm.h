@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include "structures.h"
+#include "command_executor.h"
+
+enum class OpCode : unsigned char {
+    Hornear, Ingrediente, Mostrador, Escribir, Libro, Receta, Discord,
+    Juego, Objeto, Mover, Posicionar, Ocultar, Quitar, Semilla,
+    SaltarSiFalso,   // evalua la condicion del comando y salta a target si es falsa
+    RepetirInicio,   // evalua cuantas veces repetir y abre el bucle
+    RepetirPaso,     // cuenta una vuelta o cierra el bucle y salta a target
+    ParaCadaInicio,  // evalua la lista y abre el bucle
+    ParaCadaPaso,    // asigna el siguiente elemento o cierra el bucle y salta a target
+    Saltar,          // salto incondicional a target
+    Definir,         // registra la receta y salta a target (despues del cuerpo)
+    Llamar,          // entra en la receta del comando
+    Retornar,        // vuelve de la receta actual
+    Comando,         // delega en CommandExecutor (errores y lineas no reconocidas)
+    Fin
+};
+
+// Instruccion ya decodificada: el comando de origen se indica por indice
+struct Instruction {
+    OpCode op;
+    int command;
+    int target;
+};
+
+class BytecodeCompiler {
+private:
+    const std::vector<Command>& code;
+    std::vector<Instruction> instructions;
+    std::vector<int> entryPoints;  // indice de comando -> instruccion
+
+    int emit(OpCode op, int command, int target = -1);
+    void compileRange(int startLine, int endLine);
+    int compileConditional(int line);
+    int compileLoop(int line);
+    int compileRecetaDefinition(int line, int endLine);
+
+public:
+    explicit BytecodeCompiler(const std::vector<Command>& code);
+    
+    std::vector<Instruction> compile();
+    const std::vector<int>& getEntryPoints() const { return entryPoints; }
+};
+
+class VirtualMachine {
+private:
+    struct LoopState {
+        long long remaining;
+        Value list;
+        size_t index;
+    };
+    
+    CommandExecutor& executor;
+
+    void run(const std::vector<Command>& code, const std::vector<Instruction>& instructions,
+             const std::vector<int>& entryPoints);
+
+public:
+    explicit VirtualMachine(CommandExecutor& executor);
+    
+    void execute(std::shared_ptr<const std::vector<Command>> program);
+};
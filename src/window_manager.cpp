@@ -1,5 +1,6 @@
 #include "window_manager.h"
 #include "utils.h"
+#include "string_table.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -205,6 +206,7 @@ void WindowManager::createWindow(const std::string& title, const std::string& co
         winInfo.hwnd = hwnd;
         winInfo.textArea = nullptr;
         winInfo.title = title;
+        winInfo.titleId = StringTable::intern(title);
         winInfo.color = colorName;
         winInfo.isActive = true;
         winInfo.content = L"";
@@ -250,8 +252,9 @@ void WindowManager::createWindow(const std::string& title, const std::string& co
 }
 
 void WindowManager::writeToWindow(const std::string& windowTitle, const std::string& text) {
+    int titleId = StringTable::intern(windowTitle);
     for (auto& win : windows) {
-        if (win.title == windowTitle && win.textArea && !win.isGameWindow) {
+        if (win.titleId == titleId && win.textArea && !win.isGameWindow) {
             int size_needed = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, NULL, 0);
             std::wstring wtext(size_needed, L'\0');
             MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, &wtext[0], size_needed);